@@ -16,6 +16,23 @@ int main(int argc, char** argv) {
                 ("c,cmake", "Generate CMakeLists.txt")
                 ("j,json", "Enable json (de)serialisation and iostream operations.",
                  cxxopts::value<bool>()->default_value("false"))
+                ("p,pmr", "Use std::pmr strings and vectors, and generate allocator-extended constructors.",
+                 cxxopts::value<bool>()->default_value("false"))
+                ("b,binary", "Enable compact binary (de)serialisation.",
+                 cxxopts::value<bool>()->default_value("false"))
+                ("flat", "Enable the flat binary form, which is read in place without deserialisation.",
+                 cxxopts::value<bool>()->default_value("false"))
+                ("msgpack", "Enable MessagePack (de)serialisation.",
+                 cxxopts::value<bool>()->default_value("false"))
+                ("cbor", "Enable CBOR (de)serialisation.",
+                 cxxopts::value<bool>()->default_value("false"))
+                ("columns", "Generate a struct-of-arrays container for each type.",
+                 cxxopts::value<bool>()->default_value("false"))
+                ("optimize-layout", "Declare the members of each type in the order that minimises padding. "
+                 "Serialisation keeps the order of the definitions, but aggregate initialisation follows the new order.",
+                 cxxopts::value<bool>()->default_value("false"))
+                ("layout-report", "Print the size, alignment and padding of each type, as laid out on this platform.",
+                 cxxopts::value<bool>()->default_value("false"))
                 ("input", "Input file containing type definitions",
                  cxxopts::value<std::string>())
                 ("h,help", "Print help message");
@@ -41,7 +58,15 @@ int main(int argc, char** argv) {
             results["input"].as<std::string>(),
             results["output"].as<std::string>(),
             results["filename"].as<std::string>(),
-            static_cast<bool>(results.count("json"))};
+            static_cast<bool>(results.count("json")),
+            static_cast<bool>(results.count("pmr")),
+            static_cast<bool>(results.count("binary")),
+            static_cast<bool>(results.count("flat")),
+            static_cast<bool>(results.count("msgpack")),
+            static_cast<bool>(results.count("cbor")),
+            static_cast<bool>(results.count("columns")),
+            static_cast<bool>(results.count("optimize-layout")),
+            static_cast<bool>(results.count("layout-report"))};
 
         valuetypes::generate(generate_options);
 
@@ -1,20 +1,227 @@
 #include "valuetypes.h"
+#include <algorithm>
+#include <bit>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <tuple>
 #include <type_traits>
 #include <utility>
 #include <variant>
-#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <charconv>
+#include <cerrno>
+#include <exception>
+#include <filesystem>
+#include <fstream>
 #include <iomanip>
-#include <limits>
+#include <istream>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#if(defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__)) && !defined(VALUETYPES_NO_SIMD)
+#define VALUETYPES_SIMD_X86
+#include <immintrin.h>
+#endif
+
+#if(defined(__unix__) || defined(__APPLE__)) && !defined(VALUETYPES_NO_MMAP)
+#define VALUETYPES_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace valuetypes { 
 
+namespace {
+
+template <typename T>
+struct is_optional : std::false_type
+{};
+
+template <typename T>
+struct is_optional<std::optional<T>> : std::true_type
+{};
+
+template <typename T>
+constexpr bool is_optional_v = is_optional<T>::value;
+
+template <typename T>
+struct is_vector : std::false_type
+{};
+
+template <typename T, typename A>
+struct is_vector<std::vector<T, A>> : std::true_type
+{};
+
+template <typename T>
+constexpr bool is_vector_v = is_vector<T>::value;
+
+template <typename T>
+struct is_std_array : std::false_type
+{};
+
+template <typename T, std::size_t N>
+struct is_std_array<std::array<T, N>> : std::true_type
+{};
+
+template <typename T>
+constexpr bool is_std_array_v = is_std_array<T>::value;
+
+template <typename T>
+struct is_variant : std::false_type
+{};
+
+template <typename... Ts>
+struct is_variant<std::variant<Ts...>> : std::true_type
+{};
+
+template <typename T>
+constexpr bool is_variant_v = is_variant<T>::value;
+
+template <typename T>
+struct is_string : std::false_type
+{};
+
+template <typename A>
+struct is_string<std::basic_string<char, std::char_traits<char>, A>> : std::true_type
+{};
+
+template <typename T>
+constexpr bool is_string_v = is_string<T>::value;
+
+template <typename T>
+struct is_fixed_string : std::false_type
+{};
+
+// key lookup for the formats with named members: the index of the member of
+// T, or of the alternative of its variant member I, or -1 for unknown keys
+template <typename T>
+struct tag {};
+
+template <std::size_t I>
+struct alternatives {};
+
+int key_index(std::string_view key, tag<TemplateParameter>) noexcept {
+    switch(key.size()) {
+    case 4:
+        switch(key[0]) {
+        case 't':
+            return key == "type" ? 0 : -1;
+        case 'n':
+            return key == "name" ? 2 : -1;
+        }
+        break;
+    case 8:
+        switch(key[0]) {
+        case 'o':
+            return key == "optional" ? 1 : -1;
+        case 'c':
+            return key == "capacity" ? 3 : -1;
+        }
+        break;
+    }
+    return -1;
+}
+
+int key_index(std::string_view key, tag<Member>) noexcept {
+    switch(key.size()) {
+    case 4:
+        switch(key[0]) {
+        case 'n':
+            return key == "name" ? 0 : -1;
+        case 't':
+            return key == "type" ? 1 : -1;
+        case 's':
+            return key == "size" ? 5 : -1;
+        }
+        break;
+    case 8:
+        switch(key[0]) {
+        case 'o':
+            return key == "optional" ? 3 : -1;
+        case 'c':
+            return key == "capacity" ? 4 : -1;
+        }
+        break;
+    case 10:
+        switch(key[0]) {
+        case 'v':
+            return key == "value_type" ? 6 : -1;
+        }
+        break;
+    case 11:
+        switch(key[0]) {
+        case 'v':
+            return key == "value_types" ? 7 : -1;
+        }
+        break;
+    case 13:
+        switch(key[0]) {
+        case 'd':
+            return key == "default_value" ? 2 : -1;
+        }
+        break;
+    }
+    return -1;
+}
+
+int key_index(std::string_view key, tag<Definition>) noexcept {
+    switch(key.size()) {
+    case 4:
+        switch(key[0]) {
+        case 'n':
+            return key == "name" ? 0 : -1;
+        }
+        break;
+    case 7:
+        switch(key[0]) {
+        case 'm':
+            return key == "members" ? 1 : -1;
+        }
+        break;
+    case 9:
+        switch(key[0]) {
+        case 'i':
+            return key == "immutable" ? 2 : -1;
+        }
+        break;
+    }
+    return -1;
+}
+
+int key_index(std::string_view key, tag<DefinitionStore>) noexcept {
+    switch(key.size()) {
+    case 2:
+        switch(key[0]) {
+        case 'n':
+            return key == "ns" ? 0 : -1;
+        }
+        break;
+    case 5:
+        switch(key[0]) {
+        case 't':
+            return key == "types" ? 1 : -1;
+        }
+        break;
+    }
+    return -1;
+}
+
+
+} // namespace
+
 bool operator==(const TemplateParameter &a, const TemplateParameter &b) noexcept {
     return
-        std::tie(a.type, a.optional, a.name) ==
-        std::tie(b.type, b.optional, b.name);
+        std::tie(a.type, a.optional, a.name, a.capacity) ==
+        std::tie(b.type, b.optional, b.name, b.capacity);
 }
 
 bool operator!=(const TemplateParameter &a, const TemplateParameter &b) noexcept {
@@ -23,8 +230,8 @@ bool operator!=(const TemplateParameter &a, const TemplateParameter &b) noexcept
 
 bool operator==(const Member &a, const Member &b) noexcept {
     return
-        std::tie(a.name, a.type, a.default_value, a.optional, a.value_type, a.value_types) ==
-        std::tie(b.name, b.type, b.default_value, b.optional, b.value_type, b.value_types);
+        std::tie(a.name, a.type, a.default_value, a.optional, a.capacity, a.size, a.value_type, a.value_types) ==
+        std::tie(b.name, b.type, b.default_value, b.optional, b.capacity, b.size, b.value_type, b.value_types);
 }
 
 bool operator!=(const Member &a, const Member &b) noexcept {
@@ -33,8 +240,8 @@ bool operator!=(const Member &a, const Member &b) noexcept {
 
 bool operator==(const Definition &a, const Definition &b) noexcept {
     return
-        std::tie(a.name, a.members) ==
-        std::tie(b.name, b.members);
+        std::tie(a.name, a.members, a.immutable) ==
+        std::tie(b.name, b.members, b.immutable);
 }
 
 bool operator!=(const Definition &a, const Definition &b) noexcept {
@@ -54,8 +261,8 @@ bool operator!=(const DefinitionStore &a, const DefinitionStore &b) noexcept {
 
 bool operator<(const TemplateParameter &a, const TemplateParameter &b) noexcept {
     return
-        std::tie(a.type, a.optional, a.name) <
-        std::tie(b.type, b.optional, b.name);
+        std::tie(a.type, a.optional, a.name, a.capacity) <
+        std::tie(b.type, b.optional, b.name, b.capacity);
 }
 
 bool operator<=(const TemplateParameter &a, const TemplateParameter &b) noexcept {
@@ -72,8 +279,8 @@ bool operator>=(const TemplateParameter &a, const TemplateParameter &b) noexcept
 
 bool operator<(const Member &a, const Member &b) noexcept {
     return
-        std::tie(a.name, a.type, a.default_value, a.optional, a.value_type, a.value_types) <
-        std::tie(b.name, b.type, b.default_value, b.optional, b.value_type, b.value_types);
+        std::tie(a.name, a.type, a.default_value, a.optional, a.capacity, a.size, a.value_type, a.value_types) <
+        std::tie(b.name, b.type, b.default_value, b.optional, b.capacity, b.size, b.value_type, b.value_types);
 }
 
 bool operator<=(const Member &a, const Member &b) noexcept {
@@ -90,8 +297,8 @@ bool operator>=(const Member &a, const Member &b) noexcept {
 
 bool operator<(const Definition &a, const Definition &b) noexcept {
     return
-        std::tie(a.name, a.members) <
-        std::tie(b.name, b.members);
+        std::tie(a.name, a.members, a.immutable) <
+        std::tie(b.name, b.members, b.immutable);
 }
 
 bool operator<=(const Definition &a, const Definition &b) noexcept {
@@ -126,6 +333,7 @@ bool operator>=(const DefinitionStore &a, const DefinitionStore &b) noexcept {
 
 
 
+
 } // } // namespace valuetypes
 
 // start iostream_definitions.cpp.inja
@@ -133,27 +341,48 @@ bool operator>=(const DefinitionStore &a, const DefinitionStore &b) noexcept {
 namespace valuetypes { 
 namespace {
 
-template <typename T>
-struct is_optional : std::false_type
-{};
-
-template <typename T>
-struct is_optional<std::optional<T>> : std::true_type
-{};
-
-template <typename T>
-constexpr bool is_optional_v = is_optional<T>::value;
-
-template <typename T>
-struct is_vector : std::false_type
-{};
+unsigned thread_count(unsigned threads) noexcept {
+    // 0 selects one thread per core
+    return threads != 0 ? threads : std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+template <typename F>
+void run_parallel(std::size_t tasks, unsigned threads, F&& task) {
+    // Runs task(worker, index) for every index in [0, tasks) on up to threads
+    // threads. Tasks are handed out one at a time, so workers that finish early
+    // take over the remaining ones. The first exception is rethrown after all
+    // workers have stopped.
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool>        failed{false};
+    std::exception_ptr       error;
+    std::mutex               error_mutex;
+
+    auto work = [&](unsigned worker) {
+        for(std::size_t i; !failed && (i = next++) < tasks;) {
+            try {
+                task(worker, i);
+            } catch(...) {
+                std::lock_guard lock(error_mutex);
+                if(!error) {
+                    error = std::current_exception();
+                }
+                failed = true;
+            }
+        }
+    };
 
-template <typename T>
-struct is_vector<std::vector<T>> : std::true_type
-{};
+    {
+        std::vector<std::jthread> pool;
+        for(unsigned worker = 1; worker < threads; ++worker) {
+            pool.emplace_back(work, worker);
+        }
+        work(0);
+    }
 
-template <typename T>
-constexpr bool is_vector_v = is_vector<T>::value;
+    if(error) {
+        std::rethrow_exception(error);
+    }
+}
 
 namespace json {
 
@@ -191,73 +420,467 @@ class json_error : public std::runtime_error {
     using std::runtime_error::runtime_error;
 };
 
-char next_token(std::istream& input) {
+struct cursor {
+    const char* pos;
+    const char* end;
+    bool        reuse{false}; // overwrite existing values in place, see from_json_reuse
+    std::string scratch;      // decoding buffer for keys that contain escapes
+};
+
+constexpr bool is_space(char c) noexcept {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' || c == '\v';
+}
+
+constexpr bool is_alnum(char c) noexcept {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+namespace scan {
+
+/*
+ * Scanning kernels for the hot loops of the parser: skipping whitespace runs,
+ * finding the end of a plain run of string characters and finding the next
+ * quote or bracket when skipping unknown values. Each kernel
+ * returns a pointer to the first byte in [p, end) that stops the scan, or end.
+ *
+ * On x86-64 the widest implementation the cpu supports is selected at runtime,
+ * SSE2 is part of the baseline so only AVX2 needs to be checked for. Define
+ * VALUETYPES_NO_SIMD to always use the scalar versions.
+ */
+
+using kernel = const char* (*)(const char*, const char*) noexcept;
+
+const char* scalar_skip_space(const char* p, const char* end) noexcept {
+    while(p != end && is_space(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+const char* scalar_find_string_special(const char* p, const char* end) noexcept {
+    while(p != end && *p != '"' && *p != '\\') {
+        ++p;
+    }
+    return p;
+}
+
+constexpr bool is_structural(char c) noexcept {
+    // '[' and ']' differ from '{' and '}' only in bit 5
+    char lower = c | 0x20;
+    return c == '"' || lower == '{' || lower == '}';
+}
+
+const char* scalar_find_structural(const char* p, const char* end) noexcept {
+    while(p != end && !is_structural(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+#ifdef VALUETYPES_SIMD_X86
+
+__attribute__((target("sse2"))) inline unsigned sse2_space_mask(__m128i chunk) noexcept {
+    // ' ' or '\t' .. '\r'
+    __m128i ctrl = _mm_sub_epi8(chunk, _mm_set1_epi8('\t'));
+    __m128i in   = _mm_cmpeq_epi8(_mm_min_epu8(ctrl, _mm_set1_epi8(4)), ctrl);
+    return _mm_movemask_epi8(_mm_or_si128(in, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(' '))));
+}
+
+__attribute__((target("sse2"))) inline unsigned sse2_special_mask(__m128i chunk) noexcept {
+    __m128i quote     = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'));
+    __m128i backslash = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'));
+    return _mm_movemask_epi8(_mm_or_si128(quote, backslash));
+}
+
+__attribute__((target("sse2"))) inline unsigned sse2_structural_mask(__m128i chunk) noexcept {
+    __m128i lower  = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+    __m128i quote  = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'));
+    __m128i open   = _mm_cmpeq_epi8(lower, _mm_set1_epi8('{'));
+    __m128i close  = _mm_cmpeq_epi8(lower, _mm_set1_epi8('}'));
+    return _mm_movemask_epi8(_mm_or_si128(quote, _mm_or_si128(open, close)));
+}
+
+__attribute__((target("sse2"))) const char* sse2_skip_space(const char* p, const char* end) noexcept {
+    for(; end - p >= 16; p += 16) {
+        unsigned mask = ~sse2_space_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) & 0xffff;
+        if(mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return scalar_skip_space(p, end);
+}
+
+__attribute__((target("sse2"))) const char* sse2_find_string_special(const char* p, const char* end) noexcept {
+    for(; end - p >= 16; p += 16) {
+        unsigned mask = sse2_special_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        if(mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return scalar_find_string_special(p, end);
+}
+
+__attribute__((target("sse2"))) const char* sse2_find_structural(const char* p, const char* end) noexcept {
+    for(; end - p >= 16; p += 16) {
+        unsigned mask = sse2_structural_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        if(mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return scalar_find_structural(p, end);
+}
+
+__attribute__((target("avx2"))) inline unsigned avx2_space_mask(__m256i chunk) noexcept {
+    __m256i ctrl = _mm256_sub_epi8(chunk, _mm256_set1_epi8('\t'));
+    __m256i in   = _mm256_cmpeq_epi8(_mm256_min_epu8(ctrl, _mm256_set1_epi8(4)), ctrl);
+    return _mm256_movemask_epi8(_mm256_or_si256(in, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' '))));
+}
+
+__attribute__((target("avx2"))) inline unsigned avx2_special_mask(__m256i chunk) noexcept {
+    __m256i quote     = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'));
+    __m256i backslash = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'));
+    return _mm256_movemask_epi8(_mm256_or_si256(quote, backslash));
+}
+
+__attribute__((target("avx2"))) inline unsigned avx2_structural_mask(__m256i chunk) noexcept {
+    __m256i lower = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+    __m256i quote = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'));
+    __m256i open  = _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('{'));
+    __m256i close = _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('}'));
+    return _mm256_movemask_epi8(_mm256_or_si256(quote, _mm256_or_si256(open, close)));
+}
+
+__attribute__((target("avx2"))) const char* avx2_skip_space(const char* p, const char* end) noexcept {
+    for(; end - p >= 32; p += 32) {
+        unsigned mask = ~avx2_space_mask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+        if(mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    // finish with scalar code, mixing in non-VEX SSE2 code here would incur
+    // a transition penalty
+    return scalar_skip_space(p, end);
+}
+
+__attribute__((target("avx2"))) const char* avx2_find_string_special(const char* p, const char* end) noexcept {
+    for(; end - p >= 32; p += 32) {
+        unsigned mask = avx2_special_mask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+        if(mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return scalar_find_string_special(p, end);
+}
+
+__attribute__((target("avx2"))) const char* avx2_find_structural(const char* p, const char* end) noexcept {
+    for(; end - p >= 32; p += 32) {
+        unsigned mask = avx2_structural_mask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+        if(mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return scalar_find_structural(p, end);
+}
+
+#endif
+
+struct kernels {
+    kernel skip_space;
+    kernel find_string_special;
+    kernel find_structural;
+};
+
+kernels select_kernels() noexcept {
+#ifdef VALUETYPES_SIMD_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) {
+        return {avx2_skip_space, avx2_find_string_special, avx2_find_structural};
+    }
+    return {sse2_skip_space, sse2_find_string_special, sse2_find_structural};
+#else
+    return {scalar_skip_space, scalar_find_string_special, scalar_find_structural};
+#endif
+}
+
+const kernels& active() noexcept {
+    static const kernels k = select_kernels();
+    return k;
+}
+
+} // namespace scan
+
+void skip_whitespace(cursor& input) noexcept {
+    // most runs are zero or one character, only hand longer (indentation)
+    // runs to the scanning kernel
+    if(input.pos != input.end && is_space(*input.pos)) {
+        ++input.pos;
+        if(input.pos != input.end && is_space(*input.pos)) {
+            input.pos = scan::active().skip_space(input.pos, input.end);
+        }
+    }
+}
+
+char next_token(cursor& input) {
     // return the next non-whitespace char
-    char c = 0;
-    while(input.get(c)) {
-        if(!isspace(c))
-            return c;
+    skip_whitespace(input);
+    if(input.pos == input.end) {
+        return std::char_traits<char>::eof();
     }
-    return std::char_traits<char>::eof();
+    return *input.pos++;
 }
 
-char peek(std::istream& input) {
-    while(true) {
-        char p = input.peek();
-        if(!input) {
-            throw json_error("peek() failed, unbufferd input?");
+char peek(cursor& input) {
+    skip_whitespace(input);
+    if(input.pos == input.end) {
+        throw json_error("unexpected end of input");
+    }
+    return *input.pos;
+}
+
+void extract_literal(cursor& input, std::string_view l) {
+    if(static_cast<std::size_t>(input.end - input.pos) < l.size() || std::string_view(input.pos, l.size()) != l) {
+        throw json_error(std::string("expected literal '") + std::string(l) + "'");
+    }
+    input.pos += l.size();
+}
+
+unsigned extract_hex4(cursor& input) {
+    if(input.end - input.pos < 4) {
+        throw json_error("truncated unicode escape");
+    }
+    unsigned value = 0;
+    for(int i = 0; i < 4; ++i) {
+        char c = *input.pos++;
+        value <<= 4;
+        if(c >= '0' && c <= '9') {
+            value |= c - '0';
+        } else if(c >= 'a' && c <= 'f') {
+            value |= c - 'a' + 10;
+        } else if(c >= 'A' && c <= 'F') {
+            value |= c - 'A' + 10;
+        } else {
+            throw json_error("invalid unicode escape");
         }
-        if(!isspace(p)) // skip whitespace
-            return p;
-        input.get();
+    }
+    return value;
+}
+
+template <typename S>
+void append_utf8(S& target, unsigned cp) {
+    if(cp < 0x80) {
+        target += static_cast<char>(cp);
+    } else if(cp < 0x800) {
+        target += static_cast<char>(0xc0 | (cp >> 6));
+        target += static_cast<char>(0x80 | (cp & 0x3f));
+    } else if(cp < 0x10000) {
+        target += static_cast<char>(0xe0 | (cp >> 12));
+        target += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+        target += static_cast<char>(0x80 | (cp & 0x3f));
+    } else {
+        target += static_cast<char>(0xf0 | (cp >> 18));
+        target += static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+        target += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+        target += static_cast<char>(0x80 | (cp & 0x3f));
     }
 }
 
-void extract_literal(std::istream& input, std::string_view l) {
-    for(char e : l) {
-        int c = input.get();
-        if(c != e) {
-            throw json_error(std::string("expected literal '") + std::string(l) + "', mismatch on char " + std::string(1, c));
+template <typename S>
+void extract_escape(cursor& input, S& target) {
+    // the backslash has been consumed
+    if(input.pos == input.end) {
+        throw json_error("unterminated string");
+    }
+    char c = *input.pos++;
+    switch(c) {
+    case 'b':
+        target += '\b';
+        break;
+    case 'f':
+        target += '\f';
+        break;
+    case 'n':
+        target += '\n';
+        break;
+    case 'r':
+        target += '\r';
+        break;
+    case 't':
+        target += '\t';
+        break;
+    case 'u': {
+        unsigned cp = extract_hex4(input);
+        if(cp >= 0xdc00 && cp < 0xe000) {
+            throw json_error("unpaired low surrogate in \\u escape");
+        }
+        if(cp >= 0xd800 && cp < 0xdc00) {
+            // a high surrogate has to be followed by an escaped low surrogate
+            if(input.end - input.pos < 6 || input.pos[0] != '\\' || input.pos[1] != 'u') {
+                throw json_error("unpaired high surrogate in \\u escape");
+            }
+            input.pos += 2;
+            unsigned low = extract_hex4(input);
+            if(low < 0xdc00 || low >= 0xe000) {
+                throw json_error("unpaired high surrogate in \\u escape");
+            }
+            cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
         }
+        append_utf8(target, cp);
+        break;
+    }
+    default:
+        // '"', '\\', '/', and leniently any other escaped char as itself
+        target += c;
     }
 }
 
-std::string extract_string(std::istream& input) {
-    std::string value;
+template <typename S>
+void extract_string(cursor& input, S& value) {
+    // assigns into value, so its existing capacity is reused
     if(peek(input) == '"') {
-        if(!(input >> std::quoted(value))) {
-            throw json_error("failed to extract string");
+        ++input.pos;
+
+        // fast path: strings without escapes are assigned in one go
+        const char* special = scan::active().find_string_special(input.pos, input.end);
+        value.assign(input.pos, special);
+        input.pos = special;
+
+        while(true) {
+            if(input.pos == input.end) {
+                throw json_error("unterminated string");
+            }
+            if(*input.pos++ == '"') {
+                break;
+            }
+            extract_escape(input, value);
+
+            special = scan::active().find_string_special(input.pos, input.end);
+            value.append(input.pos, special);
+            input.pos = special;
         }
     } else {
         // read until the next ws or special char, interpret as string
         // this allows the qol of not always having to quote strings
-        char c;
-        while (input && (c = input.peek()) && (std::isalnum(c) || c == '+' || c == '-' || c == '.')) {
-            value += c;
-            input.get();
+        const char* begin = input.pos;
+        while(input.pos != input.end && (is_alnum(*input.pos) || *input.pos == '+' || *input.pos == '-' || *input.pos == '.')) {
+            ++input.pos;
         }
+        value.assign(begin, input.pos);
 
-        if (value.empty()) {
+        if(value.empty()) {
             throw json_error("failed to extract string");
         }
     }
-    return value;
+}
+
+constexpr bool is_digit(char c) noexcept {
+    return c >= '0' && c <= '9';
+}
+
+bool is_eight_digits(std::uint64_t chunk) noexcept {
+    // every byte in '0' .. '9'
+    return ((chunk & 0xf0f0f0f0f0f0f0f0) | (((chunk + 0x0606060606060606) & 0xf0f0f0f0f0f0f0f0) >> 4)) == 0x3333333333333333;
+}
+
+std::uint32_t parse_eight_digits(std::uint64_t chunk) noexcept {
+    // SWAR: combine the digits pairwise, then the pairs, then the quads
+    chunk = ((chunk & 0x0f0f0f0f0f0f0f0f) * 2561) >> 8;
+    chunk = ((chunk & 0x00ff00ff00ff00ff) * 6553601) >> 16;
+    return static_cast<std::uint32_t>(((chunk & 0x0000ffff0000ffff) * 42949672960001) >> 32);
 }
 
 template <typename T>
-T extract_value(std::istream& input) {
-    if constexpr(std::is_same_v<T, std::string>) {
-        return extract_string(input);
+T extract_integer(cursor& input) {
+    peek(input);
+
+    bool negative = false;
+    if(*input.pos == '-') {
+        negative = true;
+        ++input.pos;
+    } else if(*input.pos == '+') {
+        ++input.pos;
+    }
+
+    // up to 19 digits always fit in 64 bits, only a 20th needs checking
+    const char*   begin = input.pos;
+    const char*   limit = input.pos + std::min<std::ptrdiff_t>(input.end - input.pos, 19);
+    std::uint64_t value = 0;
+
+    if constexpr(std::endian::native == std::endian::little) {
+        while(limit - input.pos >= 8) {
+            std::uint64_t chunk;
+            std::memcpy(&chunk, input.pos, sizeof(chunk));
+            if(!is_eight_digits(chunk)) {
+                break;
+            }
+            value = value * 100000000 + parse_eight_digits(chunk);
+            input.pos += 8;
+        }
+    }
+
+    for(; input.pos != limit && is_digit(*input.pos); ++input.pos) {
+        value = value * 10 + (*input.pos - '0');
+    }
+
+    if(input.pos != input.end && is_digit(*input.pos)) {
+        unsigned digit = *input.pos++ - '0';
+        if(value > (std::numeric_limits<std::uint64_t>::max() - digit) / 10 || (input.pos != input.end && is_digit(*input.pos))) {
+            throw json_error("integer out of range");
+        }
+        value = value * 10 + digit;
+    }
+
+    if(input.pos == begin) {
+        throw json_error("could not extract number");
+    }
+    if(input.pos != input.end && (*input.pos == '.' || *input.pos == 'e' || *input.pos == 'E')) {
+        throw json_error("expected an integer");
+    }
+
+    using U = std::make_unsigned_t<T>;
+    if constexpr(std::is_signed_v<T>) {
+        std::uint64_t limit = static_cast<std::uint64_t>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+        if(value > limit) {
+            throw json_error("integer out of range");
+        }
+        return static_cast<T>(negative ? static_cast<U>(0 - value) : static_cast<U>(value));
     } else {
-        static_assert(std::is_arithmetic_v<T>, "type decution failed");
-        T v;
-        if(!(input >> v)) {
-            throw json_error("could not extract number");
+        if(value > std::numeric_limits<T>::max() || (negative && value != 0)) {
+            throw json_error("integer out of range");
         }
-        return v;
+        return static_cast<T>(value);
+    }
+}
+
+template <typename T>
+T extract_float(cursor& input) {
+    peek(input);
+    if(*input.pos == '+') {
+        ++input.pos;
     }
+
+    // from_chars is locale independent and correctly rounded
+    T v;
+    auto [ptr, ec] = std::from_chars(input.pos, input.end, v);
+    if(ec == std::errc::result_out_of_range) {
+        throw json_error("number out of range");
+    } else if(ec != std::errc()) {
+        throw json_error("could not extract number");
+    }
+    input.pos = ptr;
+    return v;
 }
 
+template <typename T>
+T extract_value(cursor& input) {
+    if constexpr(std::is_same_v<T, bool>) {
+        return extract_integer<int>(input) != 0;
+    } else if constexpr(std::is_floating_point_v<T>) {
+        return extract_float<T>(input);
+    } else {
+        static_assert(std::is_integral_v<T>, "type decution failed");
+        return extract_integer<T>(input);
+    }
+}
 
 void expect(char e, char actual) {
     if(actual != e) {
@@ -265,7 +888,7 @@ void expect(char e, char actual) {
     }
 }
 
-char expect_and_consume(std::istream& input, char e) {
+char expect_and_consume(cursor& input, char e) {
     auto t = next_token(input);
     expect(e, t);
     return t;
@@ -274,40 +897,82 @@ char expect_and_consume(std::istream& input, char e) {
 struct sink {};
 
 template <typename T>
-void value(std::istream& input, T& target);
+void value(cursor& input, T& target);
 
 template <typename T>
-void value(std::istream& input, sink target);
+void value(cursor& input, sink target);
 
 template <typename T>
-void object(std::istream& input, T& target);
+void object(cursor& input, T& target);
 
 template <typename T>
-void members(std::istream& input, T& target);
+void members(cursor& input, T& target);
 
 template <typename T>
-void member(std::istream& input, T& target);
+void member(cursor& input, T& target);
 
 template <typename T>
-void array(std::istream& input, T& target);
+void array(cursor& input, T& target);
 
 template <typename T>
-void element(std::istream& input, T& target);
+void element(cursor& input, T& target);
 
 template <typename T>
-void elements(std::istream& input, T& target);
+void elements(cursor& input, T& target);
+
+template <typename T, std::size_t N>
+void elements(cursor& input, std::array<T, N>& target);
 
 template <typename T>
-void value(std::istream& input, T& target) {
+struct is_columns : std::false_type
+{};
+
+// forward declarations
+void object(cursor &input, TemplateParameter &target);
+void object(cursor &input, Member &target);
+void object(cursor &input, Definition &target);
+void object(cursor &input, DefinitionStore &target);
+
+template <typename T>
+void reset(T& target) {
+    // back to a default value, keeping capacity where the type has any
+    if constexpr(is_string_v<T> || is_vector_v<T>) {
+        target.clear();
+    } else if constexpr(is_optional_v<T>) {
+        target.reset();
+    } else {
+        target = T{};
+    }
+}
+
+template <typename T, typename D>
+void reset(T& target, D&& default_value) {
+    target = std::forward<D>(default_value);
+}
+
+template <typename T>
+void emplace(cursor& input, std::optional<T>& target) {
+    target.emplace();
+}
+
+template <std::size_t I, typename... Ts>
+void emplace(cursor& input, std::variant<Ts...>& target) {
+    target.template emplace<I>();
+}
+
+template <typename T>
+void value(cursor& input, T& target) {
     if constexpr(is_optional_v<T>) {
         if(peek(input) == 'n' /* ull */) {
             extract_literal(input, "null");
             target.reset();
         } else {
-            target.emplace();
+            if(!input.reuse || !target) {
+                emplace(input, target);
+            }
             value(input, *target);
         }
-    } else if constexpr(is_vector_v<T>) {
+    } else if constexpr(is_vector_v<T> || is_std_array_v<T> || is_columns<T>::value) {
         array(input, target);
     } else if constexpr(std::is_same_v<bool, T>) {
         if(peek(input) == 't' /* rue */) {
@@ -319,7 +984,15 @@ void value(std::istream& input, T& target) {
         } else {
             target = extract_value<bool>(input);
         }
-    } else if constexpr(std::is_arithmetic_v<T> || std::is_same_v<std::string, T>) {
+    } else if constexpr(is_fixed_string<T>::value) {
+        try {
+            extract_string(input, target);
+        } catch(const std::length_error&) {
+            throw json_error("string longer than its capacity of " + std::to_string(T::capacity()));
+        }
+    } else if constexpr(is_string_v<T>) {
+        extract_string(input, target);
+    } else if constexpr(std::is_arithmetic_v<T>) {
         target = extract_value<T>(input);
     } else {
         static_assert(std::is_class_v<T>, "type deduction failed");
@@ -327,17 +1000,66 @@ void value(std::istream& input, T& target) {
     }
 }
 
-void value(std::istream& input, sink target) {
+constexpr bool is_number_char(char c) noexcept {
+    return is_digit(c) || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-';
+}
+
+void skip_string(cursor& input) {
+    // the opening quote has been consumed, escapes are stepped over without
+    // decoding them
+    const auto find_string_special = scan::active().find_string_special;
+    while(true) {
+        input.pos = find_string_special(input.pos, input.end);
+        if(input.pos == input.end) {
+            throw json_error("unterminated string");
+        }
+        if(*input.pos++ == '"') {
+            return;
+        }
+        if(input.pos == input.end) {
+            throw json_error("unterminated string");
+        }
+        ++input.pos;
+    }
+}
+
+void skip_nested(cursor& input) {
+    // the opening bracket has been consumed; only quotes and brackets are
+    // looked at, so a skipped value is checked for balanced nesting but not
+    // validated any further
+    const auto find_structural = scan::active().find_structural;
+    std::size_t depth = 1;
+    while(true) {
+        input.pos = find_structural(input.pos, input.end);
+        if(input.pos == input.end) {
+            throw json_error("unexpected end of input");
+        }
+        switch(*input.pos++) {
+        case '"':
+            skip_string(input);
+            break;
+        case '{':
+        case '[':
+            ++depth;
+            break;
+        default:
+            if(--depth == 0) {
+                return;
+            }
+        }
+    }
+}
+
+void value(cursor& input, sink) {
+    // values of unknown members are skipped without allocating or converting
+    // anything
     char c = peek(input);
     switch(c) {
     case '{':
-        object(input, target);
+    case '[':
+        ++input.pos;
+        skip_nested(input);
         break;
-    case '[': {
-        std::vector<sink> v;
-        array(input, v);
-        break;
-    }
     case 'n':
         extract_literal(input, "null");
         break;
@@ -348,24 +1070,24 @@ void value(std::istream& input, sink target) {
         extract_literal(input, "true");
         break;
     case '"':
-        extract_string(input);
+        ++input.pos;
+        skip_string(input);
         break;
     default:
-        if((c >= '0' && c <= '9') || c == '+' || c == '-' || c == ',') {
-            extract_value<double>(input);
+        // the numbers extract_integer and extract_float accept
+        if(is_digit(c) || c == '-' || c == '+' || c == '.') {
+            ++input.pos;
+            while(input.pos != input.end && is_number_char(*input.pos)) {
+                ++input.pos;
+            }
         } else {
             throw json_error(std::string("expected value, found '") + c + "'");
         }
     }
 }
 
-// forward declarations
-void member(std::istream &input, TemplateParameter &target);
-void member(std::istream &input, Member &target);
-void member(std::istream &input, Definition &target);
-void member(std::istream &input, DefinitionStore &target);
 template <typename T>
-void object(std::istream& input, T& target) {
+void object(cursor& input, T& target) {
     // object
     //   '{' ws '}' | '{' members '}'
     expect_and_consume(input, '{');
@@ -378,7 +1100,7 @@ void object(std::istream& input, T& target) {
 }
 
 template <typename T>
-void array(std::istream& input, T& target) {
+void array(cursor& input, T& target) {
     // array
     //   '[' ws ']' | '[' elements ']'
 
@@ -386,38 +1108,75 @@ void array(std::istream& input, T& target) {
 
     if(peek(input) != ']') {
         elements(input, target);
+    } else if constexpr(is_std_array_v<T>) {
+        if(target.size() != 0) {
+            throw json_error("expected " + std::to_string(target.size()) + " elements, found 0");
+        }
+    } else {
+        target.clear();
     }
 
     expect_and_consume(input, ']');
 }
 
 template <typename T>
-void elements(std::istream& input, T& target) {
+void elements(cursor& input, T& target) {
     // elements
     //   element | element ',' elements
     static_assert(is_vector_v<T>, "expected a vector");
 
-    target.clear();
+    // in reuse mode existing elements are overwritten, and only the surplus
+    // is destroyed
+    if(!input.reuse) {
+        target.clear();
+    }
+
+    std::size_t count = 0;
+    while(true) {
+        if(count == target.size()) {
+            target.emplace_back();
+        }
+        element(input, target[count++]);
+
+        if(peek(input) != ',') {
+            break;
+        }
+        next_token(input);
+    }
+
+    target.erase(target.begin() + count, target.end());
+}
+
+template <typename T, std::size_t N>
+void elements(cursor& input, std::array<T, N>& target) {
+    // exactly N elements, parsed in place
+    std::size_t count = 0;
     while(true) {
-        target.emplace_back();
-        element(input, target.back());
+        if(count == N) {
+            throw json_error("expected " + std::to_string(N) + " elements, found more");
+        }
+        element(input, target[count++]);
 
         if(peek(input) != ',') {
             break;
         }
         next_token(input);
     }
+
+    if(count != N) {
+        throw json_error("expected " + std::to_string(N) + " elements, found " + std::to_string(count));
+    }
 }
 
 template <typename T>
-void element(std::istream& input, T& target) {
+void element(cursor& input, T& target) {
     // element
     //   ws value ws
     value(input, target);
 }
 
 template <typename T>
-void members(std::istream& input, T& target) {
+void members(cursor& input, T& target) {
     // members
     //   member | member ',' members
     while(true) {
@@ -429,16 +1188,28 @@ void members(std::istream& input, T& target) {
     }
 }
 
-std::string extract_key(std::istream& input) {
-    expect_and_consume(input, '"');
-    input.unget();
-    auto key = extract_string(input);
+std::string_view extract_key(cursor& input) {
+    // Keys are matched in place: the returned view points into the input, or
+    // into the scratch buffer when the key contains escapes.
+    expect('"', peek(input));
+
+    std::string_view key;
+    const char*      begin   = input.pos + 1;
+    const char*      special = scan::active().find_string_special(begin, input.end);
+    if(special != input.end && *special == '"') {
+        key       = std::string_view(begin, special - begin);
+        input.pos = special + 1;
+    } else {
+        extract_string(input, input.scratch);
+        key = input.scratch;
+    }
+
     expect_and_consume(input, ':');
     return key;
 }
 
 template <typename T>
-void member(std::istream& input, T& target) {
+void member(cursor& input, T& target) {
     // member
     //   ws string ws ':' element
 
@@ -446,292 +1217,1894 @@ void member(std::istream& input, T& target) {
     element(input, target);
 }
 
-void member(std::istream &input, TemplateParameter &target) {
-    auto key = extract_key(input);
-    if(key == "type") {
+template <typename Target>
+int member(cursor &input, Target &target, tag<TemplateParameter>) {
+    // Target is TemplateParameter, or a row of its columns
+    auto key   = extract_key(input);
+    int  index = key_index(key, tag<TemplateParameter>{});
+    switch(index) {
+    case 0: {
         element(input, target.type);
-    } 
-    else if(key == "optional") {
+        break;
+    }
+    case 1: {
         element(input, target.optional);
-    } 
-    else if(key == "name") {
+        break;
+    }
+    case 2: {
         element(input, target.name);
-    } 
-    else {
+        break;
+    }
+    case 3: {
+        element(input, target.capacity);
+        break;
+    }
+    default: {
         sink s;
         element(input, s);
     }
+    }
+    return index;
+}
+
+template <typename Target>
+void object(cursor &input, Target &target, tag<TemplateParameter>) {
+    // object
+    //   '{' ws '}' | '{' members '}'
+    //
+    // tracks which members were present, so in reuse mode the others can be
+    // reset to their defaults
+    std::bitset<4> seen;
+
+    expect_and_consume(input, '{');
+
+    if(peek(input) == '"') {
+        // members
+        //   member | member ',' members
+        while(true) {
+            if(int index = member(input, target, tag<TemplateParameter>{}); index >= 0) {
+                seen.set(index);
+            }
+            if(peek(input) != ',') {
+                break;
+            }
+            next_token(input);
+        }
+    }
+
+    expect_and_consume(input, '}');
+
+    if(input.reuse) {
+        if(!seen[0]) {
+            reset(target.type);
+        }
+        if(!seen[1]) {
+            reset(target.optional, false);
+        }
+        if(!seen[2]) {
+            reset(target.name);
+        }
+        if(!seen[3]) {
+            reset(target.capacity);
+        }
+    }
+}
+
+void object(cursor &input, TemplateParameter &target) {
+    object(input, target, tag<TemplateParameter>{});
 }
-void member(std::istream &input, Member &target) {
-    auto key = extract_key(input);
-    if(key == "name") {
+
+template <typename Target>
+int member(cursor &input, Target &target, tag<Member>) {
+    // Target is Member, or a row of its columns
+    auto key   = extract_key(input);
+    int  index = key_index(key, tag<Member>{});
+    switch(index) {
+    case 0: {
         element(input, target.name);
-    } 
-    else if(key == "type") {
+        break;
+    }
+    case 1: {
         element(input, target.type);
-    } 
-    else if(key == "default_value") {
+        break;
+    }
+    case 2: {
         element(input, target.default_value);
-    } 
-    else if(key == "optional") {
+        break;
+    }
+    case 3: {
         element(input, target.optional);
-    } 
-    else if(key == "value_type") {
+        break;
+    }
+    case 4: {
+        element(input, target.capacity);
+        break;
+    }
+    case 5: {
+        element(input, target.size);
+        break;
+    }
+    case 6: {
         element(input, target.value_type);
-    } 
-    else if(key == "value_types") {
+        break;
+    }
+    case 7: {
         element(input, target.value_types);
-    } 
-    else {
-        sink s;
-        element(input, s);
+        break;
     }
-}
-void member(std::istream &input, Definition &target) {
-    auto key = extract_key(input);
-    if(key == "name") {
-        element(input, target.name);
-    } 
-    else if(key == "members") {
-        element(input, target.members);
-    } 
-    else {
+    default: {
         sink s;
         element(input, s);
     }
-}
-void member(std::istream &input, DefinitionStore &target) {
-    auto key = extract_key(input);
-    if(key == "ns") {
-        element(input, target.ns);
-    } 
-    else if(key == "types") {
-        element(input, target.types);
-    } 
-    else {
-        sink s;
-        element(input, s);
     }
+    return index;
 }
 
-} // namespace json
+template <typename Target>
+void object(cursor &input, Target &target, tag<Member>) {
+    // object
+    //   '{' ws '}' | '{' members '}'
+    //
+    // tracks which members were present, so in reuse mode the others can be
+    // reset to their defaults
+    std::bitset<8> seen;
 
-template <typename T>
-void to_json(std::ostream& out, const T& v) {
-    if constexpr (is_optional_v<T>) {
-        if (!v) {
-            out << "null";
-        } else {
-            to_json(out, *v);
-        }
-    } else if constexpr (is_vector_v<T>) {
-        out << "[ ";
-        bool first{true};
-        for (auto&& item : v) {
-            if(first) {
-                first = false;
-            } else {
-                out << ", ";
+    expect_and_consume(input, '{');
+
+    if(peek(input) == '"') {
+        // members
+        //   member | member ',' members
+        while(true) {
+            if(int index = member(input, target, tag<Member>{}); index >= 0) {
+                seen.set(index);
+            }
+            if(peek(input) != ',') {
+                break;
             }
-            to_json(out, item);
+            next_token(input);
         }
-        out << ']';
-    } else if constexpr(std::is_same_v<bool, T>) {
-        out << std::boolalpha << v;
-    } else if constexpr(std::is_floating_point_v<T>) {
-        out.precision(std::numeric_limits<double>::max_digits10);
-        out << v;
-    } else if constexpr(std::is_same_v<std::string, T>) {
-        out << std::quoted(v);
-    } else {
-        out << v;
     }
-}
 
-} // anonymous namespace
+    expect_and_consume(input, '}');
 
-void to_json(std::ostream& out, const TemplateParameter &v) {
-    out << "{ ";
-    out << std::quoted("type") << ": ";
-    to_json(out, v.type);
-    out << ", ";
-    out << std::quoted("optional") << ": ";
-    to_json(out, v.optional);
-    out << ", ";
-    out << std::quoted("name") << ": ";
-    to_json(out, v.name);
-    out << '}';
+    if(input.reuse) {
+        if(!seen[0]) {
+            reset(target.name);
+        }
+        if(!seen[1]) {
+            reset(target.type);
+        }
+        if(!seen[2]) {
+            reset(target.default_value);
+        }
+        if(!seen[3]) {
+            reset(target.optional, false);
+        }
+        if(!seen[4]) {
+            reset(target.capacity);
+        }
+        if(!seen[5]) {
+            reset(target.size);
+        }
+        if(!seen[6]) {
+            reset(target.value_type);
+        }
+        if(!seen[7]) {
+            reset(target.value_types);
+        }
+    }
 }
 
-void from_json(std::istream& in, TemplateParameter &v) {
-    json::value(in, v);
+void object(cursor &input, Member &target) {
+    object(input, target, tag<Member>{});
 }
 
-void to_json(std::ostream& out, const Member &v) {
-    out << "{ ";
-    out << std::quoted("name") << ": ";
-    to_json(out, v.name);
-    out << ", ";
-    out << std::quoted("type") << ": ";
-    to_json(out, v.type);
-    out << ", ";
-    out << std::quoted("default_value") << ": ";
-    to_json(out, v.default_value);
-    out << ", ";
-    out << std::quoted("optional") << ": ";
-    to_json(out, v.optional);
-    out << ", ";
-    out << std::quoted("value_type") << ": ";
-    to_json(out, v.value_type);
-    out << ", ";
-    out << std::quoted("value_types") << ": ";
-    to_json(out, v.value_types);
-    out << '}';
+template <typename Target>
+int member(cursor &input, Target &target, tag<Definition>) {
+    // Target is Definition, or a row of its columns
+    auto key   = extract_key(input);
+    int  index = key_index(key, tag<Definition>{});
+    switch(index) {
+    case 0: {
+        element(input, target.name);
+        break;
+    }
+    case 1: {
+        element(input, target.members);
+        break;
+    }
+    case 2: {
+        element(input, target.immutable);
+        break;
+    }
+    default: {
+        sink s;
+        element(input, s);
+    }
+    }
+    return index;
 }
 
-void from_json(std::istream& in, Member &v) {
-    json::value(in, v);
-}
+template <typename Target>
+void object(cursor &input, Target &target, tag<Definition>) {
+    // object
+    //   '{' ws '}' | '{' members '}'
+    //
+    // tracks which members were present, so in reuse mode the others can be
+    // reset to their defaults
+    std::bitset<3> seen;
 
-void to_json(std::ostream& out, const Definition &v) {
-    out << "{ ";
-    out << std::quoted("name") << ": ";
-    to_json(out, v.name);
-    out << ", ";
-    out << std::quoted("members") << ": ";
-    to_json(out, v.members);
-    out << '}';
-}
+    expect_and_consume(input, '{');
 
-void from_json(std::istream& in, Definition &v) {
-    json::value(in, v);
-}
+    if(peek(input) == '"') {
+        // members
+        //   member | member ',' members
+        while(true) {
+            if(int index = member(input, target, tag<Definition>{}); index >= 0) {
+                seen.set(index);
+            }
+            if(peek(input) != ',') {
+                break;
+            }
+            next_token(input);
+        }
+    }
 
-void to_json(std::ostream& out, const DefinitionStore &v) {
-    out << "{ ";
-    out << std::quoted("ns") << ": ";
-    to_json(out, v.ns);
-    out << ", ";
-    out << std::quoted("types") << ": ";
-    to_json(out, v.types);
-    out << '}';
-}
+    expect_and_consume(input, '}');
 
-void from_json(std::istream& in, DefinitionStore &v) {
-    json::value(in, v);
+    if(input.reuse) {
+        if(!seen[0]) {
+            reset(target.name);
+        }
+        if(!seen[1]) {
+            reset(target.members);
+        }
+        if(!seen[2]) {
+            reset(target.immutable, false);
+        }
+    }
 }
 
-} // namespace valuetypes
-
-namespace std {
-
-std::ostream &operator<<(std::ostream& out, const valuetypes::TemplateParameter &v) {
-    valuetypes::to_json(out, v);
-    return out;
+void object(cursor &input, Definition &target) {
+    object(input, target, tag<Definition>{});
 }
 
-std::istream &operator>>(std::istream& in, valuetypes::TemplateParameter &v) {
-    valuetypes::from_json(in, v);
-    return in;
+template <typename Target>
+int member(cursor &input, Target &target, tag<DefinitionStore>) {
+    // Target is DefinitionStore, or a row of its columns
+    auto key   = extract_key(input);
+    int  index = key_index(key, tag<DefinitionStore>{});
+    switch(index) {
+    case 0: {
+        element(input, target.ns);
+        break;
+    }
+    case 1: {
+        element(input, target.types);
+        break;
+    }
+    default: {
+        sink s;
+        element(input, s);
+    }
+    }
+    return index;
 }
 
-std::ostream &operator<<(std::ostream& out, const valuetypes::Member &v) {
-    valuetypes::to_json(out, v);
-    return out;
-}
+template <typename Target>
+void object(cursor &input, Target &target, tag<DefinitionStore>) {
+    // object
+    //   '{' ws '}' | '{' members '}'
+    //
+    // tracks which members were present, so in reuse mode the others can be
+    // reset to their defaults
+    std::bitset<2> seen;
 
-std::istream &operator>>(std::istream& in, valuetypes::Member &v) {
-    valuetypes::from_json(in, v);
-    return in;
-}
+    expect_and_consume(input, '{');
 
-std::ostream &operator<<(std::ostream& out, const valuetypes::Definition &v) {
-    valuetypes::to_json(out, v);
-    return out;
-}
+    if(peek(input) == '"') {
+        // members
+        //   member | member ',' members
+        while(true) {
+            if(int index = member(input, target, tag<DefinitionStore>{}); index >= 0) {
+                seen.set(index);
+            }
+            if(peek(input) != ',') {
+                break;
+            }
+            next_token(input);
+        }
+    }
 
-std::istream &operator>>(std::istream& in, valuetypes::Definition &v) {
-    valuetypes::from_json(in, v);
-    return in;
-}
+    expect_and_consume(input, '}');
 
-std::ostream &operator<<(std::ostream& out, const valuetypes::DefinitionStore &v) {
-    valuetypes::to_json(out, v);
-    return out;
+    if(input.reuse) {
+        if(!seen[0]) {
+            reset(target.ns);
+        }
+        if(!seen[1]) {
+            reset(target.types);
+        }
+    }
 }
 
-std::istream &operator>>(std::istream& in, valuetypes::DefinitionStore &v) {
-    valuetypes::from_json(in, v);
-    return in;
+void object(cursor &input, DefinitionStore &target) {
+    object(input, target, tag<DefinitionStore>{});
 }
 
-} // namespace std
-
-// end iostream_definitions.cpp.inja
-
-// start hash_definitions.cpp.inja
-
-namespace std {
 
-namespace {
+template <typename T>
+void parse(std::string_view in, T& target, bool reuse = false) {
+    // json
+    //   element
+    cursor input{in.data(), in.data() + in.size(), reuse};
+    element(input, target);
 
-constexpr std::size_t combine(std::size_t a, std::size_t b) noexcept {
-    return a ^ (b + 0x9e3779b9 + (a << 6) + (a >> 2));
+    skip_whitespace(input);
+    if(input.pos != input.end) {
+        throw json_error(std::string("unexpected trailing character '") + *input.pos + "'");
+    }
 }
 
-template <typename T>
-constexpr std::size_t base_hash(const T&v) noexcept {
-    std::hash<T> hasher;
-    return hasher(v);
+void extract_document(std::istream& input, std::string& document) {
+    // Copy exactly one json value from the stream into a contiguous buffer, so
+    // it can be handed to the pointer based parser. This works directly on the
+    // streambuf, which avoids the per-character sentry and virtual call overhead
+    // of istream::get(). The buffer is assigned to, so its capacity is reused.
+    std::istream::sentry sentry(input); // skips leading whitespace
+    if(!sentry) {
+        throw json_error("could not read from stream");
+    }
+
+    using traits = std::istream::traits_type;
+    auto* buf = input.rdbuf();
+
+    document.clear();
+    int         depth     = 0;
+    bool        in_string = false;
+    bool        escaped   = false;
+
+    for(auto i = buf->sgetc(); !traits::eq_int_type(i, traits::eof()); i = buf->snextc()) {
+        char c = traits::to_char_type(i);
+
+        if(in_string) {
+            document += c;
+            if(escaped) {
+                escaped = false;
+            } else if(c == '\\') {
+                escaped = true;
+            } else if(c == '"') {
+                in_string = false;
+                if(depth == 0) {
+                    buf->sbumpc();
+                    return;
+                }
+            }
+        } else if(depth == 0 && !document.empty() && (is_space(c) || c == ',' || c == ']' || c == '}')) {
+            // end of a top level scalar, leave the delimiter in the stream
+            return;
+        } else {
+            document += c;
+            if(c == '"') {
+                in_string = true;
+            } else if(c == '{' || c == '[') {
+                ++depth;
+            } else if((c == '}' || c == ']') && --depth == 0) {
+                buf->sbumpc();
+                return;
+            }
+        }
+    }
+
+    input.setstate(std::ios_base::eofbit);
+}
+
+template <typename Peek, typename Consume>
+bool frame(json_record_source::framing& state, Peek peek, Consume consume) {
+    // Positions the input at the start of the next record, or returns false at
+    // the end of the input. peek() skips whitespace and returns the next char
+    // as an int_type, or eof.
+    //
+    // records
+    //   ws | ws value records | ws '[' ws ']' ws | ws '[' elements ']' ws
+    using framing = json_record_source::framing;
+    using traits  = std::char_traits<char>;
+
+    auto c = peek();
+    switch(state) {
+    case framing::start:
+        if(c == '[') {
+            consume();
+            state = framing::first_element;
+            return frame(state, peek, consume);
+        }
+        state = framing::values;
+        [[fallthrough]];
+    case framing::values:
+        return !traits::eq_int_type(c, traits::eof());
+    case framing::first_element:
+        if(c != ']') {
+            state = framing::elements;
+            break;
+        }
+        [[fallthrough]];
+    case framing::elements:
+        if(c == ',') {
+            consume();
+            c = peek();
+            break;
+        } else if(c == ']') {
+            consume();
+            state = framing::end;
+            if(!traits::eq_int_type(peek(), traits::eof())) {
+                throw json_error("unexpected trailing characters after array");
+            }
+            return false;
+        }
+        throw json_error("expected ',' or ']' between array elements");
+    case framing::end:
+        return false;
+    }
+
+    if(traits::eq_int_type(c, traits::eof())) {
+        throw json_error("unterminated array");
+    }
+    return true;
+}
+
+template <typename T>
+bool next_record(json_record_source& source, T& target) {
+    using traits = std::char_traits<char>;
+
+    if(source.stream) {
+        auto* buf  = source.stream->rdbuf();
+        auto  peek = [buf] {
+            auto i = buf->sgetc();
+            while(!traits::eq_int_type(i, traits::eof()) && is_space(traits::to_char_type(i))) {
+                i = buf->snextc();
+            }
+            return i;
+        };
+        auto consume = [buf] { buf->sbumpc(); };
+
+        if(!frame(source.state, peek, consume)) {
+            return false;
+        }
+        extract_document(*source.stream, source.document);
+        parse(source.document, target, true);
+    } else {
+        cursor input{source.pos, source.end, true};
+        auto   peek = [&input] {
+            skip_whitespace(input);
+            return input.pos == input.end ? traits::eof() : traits::to_int_type(*input.pos);
+        };
+        auto consume = [&input] { ++input.pos; };
+
+        bool found = frame(source.state, peek, consume);
+        if(found) {
+            element(input, target);
+        }
+        source.pos = input.pos;
+        return found;
+    }
+    return true;
+}
+
+template <typename T>
+struct is_view : std::false_type
+{};
+
+template <>
+struct is_view<TemplateParameterView> : std::true_type
+{};
+
+template <>
+struct is_view<MemberView> : std::true_type
+{};
+
+template <>
+struct is_view<DefinitionView> : std::true_type
+{};
+
+template <>
+struct is_view<DefinitionStoreView> : std::true_type
+{};
+
+template <typename T>
+struct is_array_view : std::false_type
+{};
+
+template <typename E>
+struct is_array_view<json_array_view<E>> : std::true_type
+{};
+
+template <typename V>
+V decode(std::string_view in);
+
+template <std::size_t N, typename F>
+void index_object(std::string_view in, std::array<std::string_view, N>& members, F key_index) {
+    // Records where the value of each known member is, skipping over the
+    // values rather than decoding them. As when parsing, a repeated key
+    // overrides earlier ones.
+    cursor input{in.data(), in.data() + in.size()};
+    expect_and_consume(input, '{');
+
+    if(peek(input) == '"') {
+        while(true) {
+            int         index = key_index(extract_key(input));
+            const char* begin = (peek(input), input.pos);
+            value(input, sink{});
+            if(index >= 0) {
+                members[index] = std::string_view(begin, input.pos - begin);
+            }
+
+            if(peek(input) != ',') {
+                break;
+            }
+            next_token(input);
+        }
+    }
+
+    expect_and_consume(input, '}');
+
+    skip_whitespace(input);
+    if(input.pos != input.end) {
+        throw json_error(std::string("unexpected trailing character '") + *input.pos + "'");
+    }
+}
+
+[[maybe_unused]] std::string_view next_element(std::string_view& rest) {
+    // Splits the json text of the first element off rest, which holds the
+    // elements of an array without its brackets. Returns an empty view with a
+    // null data pointer once rest is exhausted.
+    cursor input{rest.data(), rest.data() + rest.size()};
+
+    skip_whitespace(input);
+    if(input.pos == input.end) {
+        rest = {};
+        return {};
+    }
+
+    const char* begin = input.pos;
+    value(input, sink{});
+    std::string_view element(begin, input.pos - begin);
+
+    skip_whitespace(input);
+    if(input.pos != input.end) {
+        expect(',', *input.pos++);
+    }
+    rest = std::string_view(input.pos, input.end - input.pos);
+    return element;
+}
+
+template <typename E>
+json_array_view<E> array_view(std::string_view in) {
+    // only the brackets are checked here, the elements are checked as they are
+    // iterated over
+    cursor input{in.data(), in.data() + in.size()};
+    expect_and_consume(input, '[');
+    skip_whitespace(input);
+
+    const char* end = input.end;
+    while(end != input.pos && is_space(end[-1])) {
+        --end;
+    }
+    if(end == input.pos || end[-1] != ']') {
+        throw json_error("expected ']'");
+    }
+    --end;
+    while(end != input.pos && is_space(end[-1])) {
+        --end;
+    }
+
+    return json_array_view<E>(std::string_view(input.pos, end - input.pos), next_element, decode<E>);
+}
+
+template <typename V>
+V decode(std::string_view in) {
+    // in is the json text of a single value, or empty for an absent member
+    if constexpr(is_optional_v<V>) {
+        if(in.empty() || in == "null") {
+            return std::nullopt;
+        }
+        return decode<typename V::value_type>(in);
+    } else if constexpr(is_view<V>::value) {
+        return in.empty() ? V() : V(in);
+    } else if constexpr(is_array_view<V>::value) {
+        return in.empty() ? V() : array_view<typename V::value_type>(in);
+    } else {
+        V v{};
+        if(!in.empty()) {
+            parse(in, v);
+        }
+        return v;
+    }
+}
+
+struct record_parts {
+    std::vector<std::string_view> parts;
+    bool                          array{false}; // the records are the elements of a top level array
+};
+
+record_parts split_records(std::string_view in, std::size_t pieces) {
+    // Cuts the records of a newline delimited json document, or the elements
+    // of a top level json array, into up to pieces parts of about equal size.
+    // Strings and nesting are followed, so cuts are only made right after a
+    // record ends, whatever whitespace the records contain. For an array the
+    // brackets are left out, and every part but the first starts with the ','
+    // in front of its first element.
+    record_parts result;
+    const char*  p   = scan::active().skip_space(in.data(), in.data() + in.size());
+    const char*  end = in.data() + in.size();
+    if(p != end && *p == '[') {
+        result.array = true;
+        while(is_space(end[-1])) {
+            --end;
+        }
+        if(end - p < 2 || end[-1] != ']') {
+            throw json_error("unterminated array");
+        }
+        ++p;
+        --end;
+    }
+
+    std::size_t target = std::max<std::size_t>((end - p) / pieces, 1);
+    const char* begin  = p;
+    int         depth  = 0;
+    while((p = scan::active().find_structural(p, end)) != end) {
+        char c = *p++;
+        if(c == '"') {
+            while((p = scan::active().find_string_special(p, end)) != end && *p++ != '"') {
+                // an escaped char, which may be a '"'
+                p += p != end;
+            }
+        } else if(c == '{' || c == '[') {
+            ++depth;
+        } else if(--depth == 0 && static_cast<std::size_t>(p - begin) >= target && p != end) {
+            result.parts.emplace_back(begin, p - begin);
+            begin = p;
+        }
+    }
+    if(begin != end) {
+        result.parts.emplace_back(begin, end - begin);
+    }
+    return result;
+}
+
+template <typename T>
+bool next_part_record(cursor& input, bool& comma, bool array, T& target) {
+    // comma is whether a ',' has to come before the next record
+    skip_whitespace(input);
+    if(input.pos == input.end) {
+        return false;
+    }
+    if(comma) {
+        if(*input.pos != ',') {
+            throw json_error("expected ',' between array elements");
+        }
+        ++input.pos;
+    }
+    element(input, target);
+    comma = array;
+    return true;
+}
+
+struct parallel_plan {
+    record_parts parts;
+    unsigned     threads;
+};
+
+parallel_plan plan_parallel(std::string_view in, unsigned threads) {
+    // A few parts per thread balances uneven records, but parts are kept large
+    // enough that small inputs are not spread over threads for nothing.
+    constexpr std::size_t min_part_size    = 64 * 1024;
+    constexpr std::size_t parts_per_thread = 4;
+
+    threads            = thread_count(threads);
+    std::size_t pieces = std::clamp<std::size_t>(in.size() / min_part_size, 1, threads * parts_per_thread);
+
+    parallel_plan plan{split_records(in, pieces), threads};
+    plan.threads = static_cast<unsigned>(std::clamp<std::size_t>(plan.parts.parts.size(), 1, threads));
+    return plan;
+}
+
+template <typename T>
+void parse_records_parallel(std::string_view in, std::vector<T>& records, unsigned threads) {
+    // records are kept in input order
+    auto  plan  = plan_parallel(in, threads);
+    auto& parts = plan.parts.parts;
+
+    std::vector<std::vector<T>> results(parts.size());
+    run_parallel(parts.size(), plan.threads, [&](unsigned, std::size_t i) {
+        cursor input{parts[i].data(), parts[i].data() + parts[i].size(), true};
+        bool   comma = plan.parts.array && i > 0;
+
+        auto& result = results[i];
+        while(true) {
+            result.emplace_back();
+            if(!next_part_record(input, comma, plan.parts.array, result.back())) {
+                result.pop_back();
+                break;
+            }
+        }
+    });
+
+    std::size_t total = 0;
+    for(auto&& result : results) {
+        total += result.size();
+    }
+
+    records.clear();
+    records.reserve(total);
+    for(auto&& result : results) {
+        std::move(result.begin(), result.end(), std::back_inserter(records));
+    }
+}
+
+template <typename T, typename F>
+std::size_t for_each_record_parallel(std::string_view in, const F& f, unsigned threads) {
+    // each worker parses into its own record, which is reused between records
+    auto  plan  = plan_parallel(in, threads);
+    auto& parts = plan.parts.parts;
+
+    std::vector<T>           records(plan.threads);
+    std::atomic<std::size_t> count{0};
+    run_parallel(parts.size(), plan.threads, [&](unsigned worker, std::size_t i) {
+        cursor input{parts[i].data(), parts[i].data() + parts[i].size(), true};
+        bool   comma = plan.parts.array && i > 0;
+
+        std::size_t n = 0;
+        for(; next_part_record(input, comma, plan.parts.array, records[worker]); ++n) {
+            f(worker, std::as_const(records[worker]));
+        }
+        count += n;
+    });
+    return count;
+}
+
+} // namespace json
+
+class mapped_file {
+    // The contents of a whole file, as a read-only memory mapping advised for
+    // sequential access. Falls back to reading the file into a buffer where
+    // mmap is not available.
+  public:
+    explicit mapped_file(const std::filesystem::path& path) {
+#ifdef VALUETYPES_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if(fd < 0) {
+            fail("could not open file", path);
+        }
+
+        struct stat st;
+        if(::fstat(fd, &st) != 0) {
+            int error = errno;
+            ::close(fd);
+            fail("could not stat file", path, error);
+        }
+
+        d_size = static_cast<std::size_t>(st.st_size);
+        if(d_size > 0) {
+            d_data = ::mmap(nullptr, d_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(d_data == MAP_FAILED) {
+                int error = errno;
+                ::close(fd);
+                fail("could not map file", path, error);
+            }
+            ::madvise(d_data, d_size, MADV_SEQUENTIAL);
+        }
+        ::close(fd); // the mapping stays valid
+#else
+        std::ifstream file(path, std::ios::binary);
+        if(!file) {
+            fail("could not open file", path);
+        }
+        d_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+#endif
+    }
+
+    ~mapped_file() {
+#ifdef VALUETYPES_MMAP
+        if(d_size > 0) {
+            ::munmap(d_data, d_size);
+        }
+#endif
+    }
+
+    mapped_file(const mapped_file&)            = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    std::string_view contents() const noexcept {
+#ifdef VALUETYPES_MMAP
+        return d_size > 0 ? std::string_view(static_cast<const char*>(d_data), d_size) : std::string_view();
+#else
+        return d_buffer;
+#endif
+    }
+
+  private:
+    [[noreturn]] static void fail(const char* what, const std::filesystem::path& path, int error = errno) {
+        throw std::filesystem::filesystem_error(what, path, std::error_code(error, std::generic_category()));
+    }
+
+#ifdef VALUETYPES_MMAP
+    void*       d_data{nullptr};
+    std::size_t d_size{0};
+#else
+    std::string d_buffer;
+#endif
+};
+
+class json_writer {
+    // Appends json to a contiguous buffer. Keys are known at generation time
+    // and are written as pre-escaped literals through raw().
+  public:
+    explicit json_writer(std::string& buffer)
+      : d_buffer(buffer) {}
+
+    void raw(std::string_view s) {
+        d_buffer.append(s);
+    }
+
+    void put(char c) {
+        d_buffer.push_back(c);
+    }
+
+    template <typename T>
+    void number(T v) {
+        char buffer[32];
+        auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), v);
+        d_buffer.append(buffer, ptr);
+    }
+
+    void string(std::string_view s) {
+        d_buffer.push_back('"');
+
+        const char* p   = s.data();
+        const char* end = p + s.size();
+        while(true) {
+            // copy runs that need no escaping in one go
+            const char* run = p;
+            while(p != end && !needs_escape(*p)) {
+                ++p;
+            }
+            d_buffer.append(run, p);
+
+            if(p == end) {
+                break;
+            }
+            escape(*p++);
+        }
+
+        d_buffer.push_back('"');
+    }
+
+    static std::size_t string_size(std::string_view s) noexcept {
+        // the exact number of characters string(s) writes
+        std::size_t size = s.size() + 2;
+        for(char c : s) {
+            if(needs_escape(c)) {
+                size += (c == '"' || c == '\\' || c == '\b' || c == '\f' || c == '\n' || c == '\r' || c == '\t') ? 1 : 5;
+            }
+        }
+        return size;
+    }
+
+  private:
+    static bool needs_escape(char c) noexcept {
+        return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+    }
+
+    void escape(char c) {
+        switch(c) {
+        case '"':
+            d_buffer.append("\\\"");
+            break;
+        case '\\':
+            d_buffer.append("\\\\");
+            break;
+        case '\b':
+            d_buffer.append("\\b");
+            break;
+        case '\f':
+            d_buffer.append("\\f");
+            break;
+        case '\n':
+            d_buffer.append("\\n");
+            break;
+        case '\r':
+            d_buffer.append("\\r");
+            break;
+        case '\t':
+            d_buffer.append("\\t");
+            break;
+        default: {
+            constexpr char hex[] = "0123456789abcdef";
+            char           u[]   = {'\\', 'u', '0', '0', hex[(c >> 4) & 0xf], hex[c & 0xf]};
+            d_buffer.append(u, sizeof(u));
+        }
+        }
+    }
+
+    std::string& d_buffer;
+};
+
+// forward declarations
+void write(json_writer& out, const TemplateParameter &v);
+void write(json_writer& out, const Member &v);
+void write(json_writer& out, const Definition &v);
+void write(json_writer& out, const DefinitionStore &v);
+
+template <typename T>
+void write(json_writer& out, const T& v) {
+    if constexpr (is_optional_v<T>) {
+        if (!v) {
+            out.raw("null");
+        } else {
+            write(out, *v);
+        }
+    } else if constexpr (is_vector_v<T> || is_std_array_v<T>) {
+        out.raw("[ ");
+        bool first{true};
+        for (auto&& item : v) {
+            if(first) {
+                first = false;
+            } else {
+                out.raw(", ");
+            }
+            write(out, item);
+        }
+        out.put(']');
+    } else if constexpr(std::is_same_v<bool, T>) {
+        out.raw(v ? "true" : "false");
+    } else if constexpr(std::is_arithmetic_v<T>) {
+        // shortest representation that round trips, (u)int8_t are written as
+        // numbers rather than characters
+        out.number(v);
+    } else {
+        static_assert(is_string_v<T>, "type deduction failed");
+        out.string(v);
+    }
 }
 
 template <typename T>
-constexpr std::size_t base_hash(const std::vector<T> &v) noexcept {
-    std::size_t h{0};
-    std::hash<T> ih;
-    for (auto&& item : v) {
-        h = combine(h, ih(item));
+std::size_t number_size(T v) noexcept {
+    if constexpr(std::is_integral_v<T>) {
+        std::size_t        size = 1;
+        unsigned long long u    = static_cast<unsigned long long>(v);
+        if constexpr(std::is_signed_v<T>) {
+            if(v < 0) {
+                ++size;
+                u = 0 - u;
+            }
+        }
+        for(; u >= 10; u /= 10) {
+            ++size;
+        }
+        return size;
+    } else {
+        // the shortest representation can only be found by formatting
+        char buffer[32];
+        auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), v);
+        return ptr - buffer;
     }
-    return h;
 }
 
+// forward declarations
+std::size_t measure(const TemplateParameter &v) noexcept;
+std::size_t measure(const Member &v) noexcept;
+std::size_t measure(const Definition &v) noexcept;
+std::size_t measure(const DefinitionStore &v) noexcept;
+
 template <typename T>
-constexpr std::size_t base_hash(const std::optional<T> &v) noexcept {
-    return v ? base_hash(*v) : 0;
+std::size_t measure(const T& v) noexcept {
+    // the exact number of characters write(out, v) produces
+    if constexpr (is_optional_v<T>) {
+        return v ? measure(*v) : 4;
+    } else if constexpr (is_vector_v<T> || is_std_array_v<T>) {
+        std::size_t size = 3 + (v.empty() ? 0 : 2 * (v.size() - 1));
+        for (auto&& item : v) {
+            size += measure(item);
+        }
+        return size;
+    } else if constexpr(std::is_same_v<bool, T>) {
+        return v ? 4 : 5;
+    } else if constexpr(std::is_arithmetic_v<T>) {
+        return number_size(v);
+    } else {
+        static_assert(is_string_v<T>, "type deduction failed");
+        return json_writer::string_size(v);
+    }
 }
 
-std::size_t hash_combine() {
-    return 0;
+std::size_t measure(const TemplateParameter &v) noexcept {
+    std::size_t size = 3;
+    size += sizeof("\"type\": ") - 1;
+    size += measure(v.type);
+    size += sizeof(", \"optional\": ") - 1;
+    size += measure(v.optional);
+    size += sizeof(", \"name\": ") - 1;
+    size += measure(v.name);
+    size += sizeof(", \"capacity\": ") - 1;
+    size += measure(v.capacity);
+    return size;
+}
+
+std::size_t measure(const Member &v) noexcept {
+    std::size_t size = 3;
+    size += sizeof("\"name\": ") - 1;
+    size += measure(v.name);
+    size += sizeof(", \"type\": ") - 1;
+    size += measure(v.type);
+    size += sizeof(", \"default_value\": ") - 1;
+    size += measure(v.default_value);
+    size += sizeof(", \"optional\": ") - 1;
+    size += measure(v.optional);
+    size += sizeof(", \"capacity\": ") - 1;
+    size += measure(v.capacity);
+    size += sizeof(", \"size\": ") - 1;
+    size += measure(v.size);
+    size += sizeof(", \"value_type\": ") - 1;
+    size += measure(v.value_type);
+    size += sizeof(", \"value_types\": ") - 1;
+    size += measure(v.value_types);
+    return size;
+}
+
+std::size_t measure(const Definition &v) noexcept {
+    std::size_t size = 3;
+    size += sizeof("\"name\": ") - 1;
+    size += measure(v.name);
+    size += sizeof(", \"members\": ") - 1;
+    size += measure(v.members);
+    size += sizeof(", \"immutable\": ") - 1;
+    size += measure(v.immutable);
+    return size;
+}
+
+std::size_t measure(const DefinitionStore &v) noexcept {
+    std::size_t size = 3;
+    size += sizeof("\"ns\": ") - 1;
+    size += measure(v.ns);
+    size += sizeof(", \"types\": ") - 1;
+    size += measure(v.types);
+    return size;
+}
+
+void write(json_writer& out, const TemplateParameter &v) {
+    out.raw("{ ");
+    out.raw("\"type\": ");
+    write(out, v.type);
+    out.raw(", \"optional\": ");
+    write(out, v.optional);
+    out.raw(", \"name\": ");
+    write(out, v.name);
+    out.raw(", \"capacity\": ");
+    write(out, v.capacity);
+    out.put('}');
+}
+
+void write(json_writer& out, const Member &v) {
+    out.raw("{ ");
+    out.raw("\"name\": ");
+    write(out, v.name);
+    out.raw(", \"type\": ");
+    write(out, v.type);
+    out.raw(", \"default_value\": ");
+    write(out, v.default_value);
+    out.raw(", \"optional\": ");
+    write(out, v.optional);
+    out.raw(", \"capacity\": ");
+    write(out, v.capacity);
+    out.raw(", \"size\": ");
+    write(out, v.size);
+    out.raw(", \"value_type\": ");
+    write(out, v.value_type);
+    out.raw(", \"value_types\": ");
+    write(out, v.value_types);
+    out.put('}');
+}
+
+void write(json_writer& out, const Definition &v) {
+    out.raw("{ ");
+    out.raw("\"name\": ");
+    write(out, v.name);
+    out.raw(", \"members\": ");
+    write(out, v.members);
+    out.raw(", \"immutable\": ");
+    write(out, v.immutable);
+    out.put('}');
+}
+
+void write(json_writer& out, const DefinitionStore &v) {
+    out.raw("{ ");
+    out.raw("\"ns\": ");
+    write(out, v.ns);
+    out.raw(", \"types\": ");
+    write(out, v.types);
+    out.put('}');
 }
 
-template <typename Head, typename... Tail>
-std::size_t hash_combine(const Head &head, Tail... tail) {
-    auto h = base_hash(head);
-    auto t = hash_combine(std::forward<Tail>(tail)...);
-    return combine(t, h);
+template <typename T>
+std::vector<std::string> write_parallel(std::span<const T> values, json_record_format format, unsigned threads) {
+    // Writes the values in parts, each part into its own buffer on one of up
+    // to threads threads. The buffers in order form the whole output.
+    constexpr std::size_t min_part_size    = 256;
+    constexpr std::size_t parts_per_thread = 4;
+
+    threads           = thread_count(threads);
+    std::size_t parts = std::clamp<std::size_t>(values.size() / min_part_size, 1, threads * parts_per_thread);
+
+    std::vector<std::string> buffers(parts);
+    run_parallel(parts, static_cast<unsigned>(std::min<std::size_t>(threads, parts)), [&](unsigned, std::size_t i) {
+        json_writer out(buffers[i]);
+        for(std::size_t j = i * values.size() / parts, last = (i + 1) * values.size() / parts; j != last; ++j) {
+            if(format == json_record_format::array) {
+                out.raw(j == 0 ? "[ " : ", ");
+            }
+            write(out, values[j]);
+            if(format == json_record_format::lines) {
+                out.put('\n');
+            }
+        }
+    });
+
+    if(format == json_record_format::array) {
+        // the same layout as a vector member
+        if(values.empty()) {
+            buffers.front() = "[ ";
+        }
+        buffers.back() += ']';
+    }
+    return buffers;
 }
 
 } // anonymous namespace
 
+void to_json(std::string& out, const TemplateParameter &v) {
+    json_writer writer(out);
+    write(writer, v);
+}
+
+std::string to_json_string(const TemplateParameter &v) {
+    std::string out;
+    out.reserve(measure(v));
+    to_json(out, v);
+    return out;
+}
+
+std::size_t json_size(const TemplateParameter &v) noexcept {
+    return measure(v);
+}
+
+void to_json(std::ostream& out, const TemplateParameter &v) {
+    // reuse the buffer between calls, but let go of the memory of an
+    // unusually large value rather than keep it for the life of the thread
+    constexpr std::size_t max_kept_capacity = 64 * 1024;
+    thread_local std::string buffer;
+    buffer.clear();
+    to_json(buffer, v);
+    out.write(buffer.data(), buffer.size());
+    if(buffer.capacity() > max_kept_capacity) {
+        std::string().swap(buffer);
+    }
+}
+
+void to_json_parallel(std::span<const TemplateParameter> values, std::string& out, json_record_format format, unsigned threads) {
+    auto buffers = write_parallel(values, format, threads);
+
+    std::size_t size = out.size();
+    for(auto&& buffer : buffers) {
+        size += buffer.size();
+    }
+    out.reserve(size);
+    for(auto&& buffer : buffers) {
+        out.append(buffer);
+    }
+}
+
+void to_json_parallel(std::span<const TemplateParameter> values, std::ostream& out, json_record_format format, unsigned threads) {
+    for(auto&& buffer : write_parallel(values, format, threads)) {
+        out.write(buffer.data(), buffer.size());
+    }
+}
+
+void from_json(std::istream& in, TemplateParameter &v) {
+    std::string document;
+    json::extract_document(in, document);
+    from_json(std::string_view(document), v);
+}
+
+void from_json(std::string_view in, TemplateParameter &v) {
+    json::parse(in, v);
+}
+
+void from_json(std::span<const std::byte> in, TemplateParameter &v) {
+    from_json(std::string_view(reinterpret_cast<const char*>(in.data()), in.size()), v);
+}
+
+void from_json_reuse(std::string_view in, TemplateParameter &v) {
+    json::parse(in, v, true);
+}
+
+void from_json_file(const std::filesystem::path& path, TemplateParameter &v) {
+    mapped_file file(path);
+    json::parse(file.contents(), v);
+}
+
+std::size_t for_each_json_record(const std::filesystem::path& path, const std::function<void(const TemplateParameter&)>& f) {
+    mapped_file file(path);
+    return json_record_reader<TemplateParameter>(file.contents()).for_each(f);
+}
+
+void from_json_records_parallel(std::string_view in, std::vector<TemplateParameter>& records, unsigned threads) {
+    json::parse_records_parallel(in, records, threads);
+}
+
+void from_json_file_parallel(const std::filesystem::path& path, std::vector<TemplateParameter>& records, unsigned threads) {
+    mapped_file file(path);
+    json::parse_records_parallel(file.contents(), records, threads);
+}
+
+std::size_t for_each_json_record_parallel(std::string_view in, const std::function<void(unsigned worker, const TemplateParameter&)>& f, unsigned threads) {
+    return json::for_each_record_parallel<TemplateParameter>(in, f, threads);
+}
+
+bool next_json_record(json_record_source& source, TemplateParameter &v) {
+    return json::next_record(source, v);
+}
+
+TemplateParameterView::TemplateParameterView(std::string_view json)
+  : d_json(json) {
+    // qualified, a member of the view may be called tag
+    json::index_object(json, d_members, [](std::string_view key) { return key_index(key, valuetypes::tag<TemplateParameter>{}); });
+}
+
+std::string TemplateParameterView::type() const {
+    auto in = d_members[0];
+    return json::decode<std::string>(in);
+}
+
+bool TemplateParameterView::optional() const {
+    auto in = d_members[1];
+    if(in.empty()) {
+        return { false };
+    }
+    return json::decode<bool>(in);
+}
+
+std::optional<std::string> TemplateParameterView::name() const {
+    auto in = d_members[2];
+    return json::decode<std::optional<std::string>>(in);
+}
+
+std::optional<unsigned int> TemplateParameterView::capacity() const {
+    auto in = d_members[3];
+    return json::decode<std::optional<unsigned int>>(in);
+}
+
+TemplateParameter TemplateParameterView::to_value() const {
+    TemplateParameter v{};
+    if(!d_json.empty()) {
+        json::parse(d_json, v);
+    }
+    return v;
+}
+
+void to_json(std::string& out, const Member &v) {
+    json_writer writer(out);
+    write(writer, v);
+}
+
+std::string to_json_string(const Member &v) {
+    std::string out;
+    out.reserve(measure(v));
+    to_json(out, v);
+    return out;
+}
+
+std::size_t json_size(const Member &v) noexcept {
+    return measure(v);
+}
+
+void to_json(std::ostream& out, const Member &v) {
+    // reuse the buffer between calls, but let go of the memory of an
+    // unusually large value rather than keep it for the life of the thread
+    constexpr std::size_t max_kept_capacity = 64 * 1024;
+    thread_local std::string buffer;
+    buffer.clear();
+    to_json(buffer, v);
+    out.write(buffer.data(), buffer.size());
+    if(buffer.capacity() > max_kept_capacity) {
+        std::string().swap(buffer);
+    }
+}
+
+void to_json_parallel(std::span<const Member> values, std::string& out, json_record_format format, unsigned threads) {
+    auto buffers = write_parallel(values, format, threads);
+
+    std::size_t size = out.size();
+    for(auto&& buffer : buffers) {
+        size += buffer.size();
+    }
+    out.reserve(size);
+    for(auto&& buffer : buffers) {
+        out.append(buffer);
+    }
+}
+
+void to_json_parallel(std::span<const Member> values, std::ostream& out, json_record_format format, unsigned threads) {
+    for(auto&& buffer : write_parallel(values, format, threads)) {
+        out.write(buffer.data(), buffer.size());
+    }
+}
+
+void from_json(std::istream& in, Member &v) {
+    std::string document;
+    json::extract_document(in, document);
+    from_json(std::string_view(document), v);
+}
+
+void from_json(std::string_view in, Member &v) {
+    json::parse(in, v);
+}
+
+void from_json(std::span<const std::byte> in, Member &v) {
+    from_json(std::string_view(reinterpret_cast<const char*>(in.data()), in.size()), v);
+}
+
+void from_json_reuse(std::string_view in, Member &v) {
+    json::parse(in, v, true);
+}
+
+void from_json_file(const std::filesystem::path& path, Member &v) {
+    mapped_file file(path);
+    json::parse(file.contents(), v);
+}
+
+std::size_t for_each_json_record(const std::filesystem::path& path, const std::function<void(const Member&)>& f) {
+    mapped_file file(path);
+    return json_record_reader<Member>(file.contents()).for_each(f);
+}
+
+void from_json_records_parallel(std::string_view in, std::vector<Member>& records, unsigned threads) {
+    json::parse_records_parallel(in, records, threads);
+}
+
+void from_json_file_parallel(const std::filesystem::path& path, std::vector<Member>& records, unsigned threads) {
+    mapped_file file(path);
+    json::parse_records_parallel(file.contents(), records, threads);
+}
+
+std::size_t for_each_json_record_parallel(std::string_view in, const std::function<void(unsigned worker, const Member&)>& f, unsigned threads) {
+    return json::for_each_record_parallel<Member>(in, f, threads);
+}
+
+bool next_json_record(json_record_source& source, Member &v) {
+    return json::next_record(source, v);
+}
+
+MemberView::MemberView(std::string_view json)
+  : d_json(json) {
+    // qualified, a member of the view may be called tag
+    json::index_object(json, d_members, [](std::string_view key) { return key_index(key, valuetypes::tag<Member>{}); });
+}
+
+std::string MemberView::name() const {
+    auto in = d_members[0];
+    return json::decode<std::string>(in);
+}
+
+std::string MemberView::type() const {
+    auto in = d_members[1];
+    return json::decode<std::string>(in);
+}
+
+std::optional<std::string> MemberView::default_value() const {
+    auto in = d_members[2];
+    return json::decode<std::optional<std::string>>(in);
+}
+
+bool MemberView::optional() const {
+    auto in = d_members[3];
+    if(in.empty()) {
+        return { false };
+    }
+    return json::decode<bool>(in);
+}
+
+std::optional<unsigned int> MemberView::capacity() const {
+    auto in = d_members[4];
+    return json::decode<std::optional<unsigned int>>(in);
+}
+
+std::optional<unsigned int> MemberView::size() const {
+    auto in = d_members[5];
+    return json::decode<std::optional<unsigned int>>(in);
+}
+
+std::optional<TemplateParameterView> MemberView::value_type() const {
+    auto in = d_members[6];
+    return json::decode<std::optional<TemplateParameterView>>(in);
+}
+
+std::optional<json_array_view<TemplateParameterView>> MemberView::value_types() const {
+    auto in = d_members[7];
+    return json::decode<std::optional<json_array_view<TemplateParameterView>>>(in);
+}
+
+Member MemberView::to_value() const {
+    Member v{};
+    if(!d_json.empty()) {
+        json::parse(d_json, v);
+    }
+    return v;
+}
+
+void to_json(std::string& out, const Definition &v) {
+    json_writer writer(out);
+    write(writer, v);
+}
+
+std::string to_json_string(const Definition &v) {
+    std::string out;
+    out.reserve(measure(v));
+    to_json(out, v);
+    return out;
+}
+
+std::size_t json_size(const Definition &v) noexcept {
+    return measure(v);
+}
+
+void to_json(std::ostream& out, const Definition &v) {
+    // reuse the buffer between calls, but let go of the memory of an
+    // unusually large value rather than keep it for the life of the thread
+    constexpr std::size_t max_kept_capacity = 64 * 1024;
+    thread_local std::string buffer;
+    buffer.clear();
+    to_json(buffer, v);
+    out.write(buffer.data(), buffer.size());
+    if(buffer.capacity() > max_kept_capacity) {
+        std::string().swap(buffer);
+    }
+}
+
+void to_json_parallel(std::span<const Definition> values, std::string& out, json_record_format format, unsigned threads) {
+    auto buffers = write_parallel(values, format, threads);
+
+    std::size_t size = out.size();
+    for(auto&& buffer : buffers) {
+        size += buffer.size();
+    }
+    out.reserve(size);
+    for(auto&& buffer : buffers) {
+        out.append(buffer);
+    }
+}
+
+void to_json_parallel(std::span<const Definition> values, std::ostream& out, json_record_format format, unsigned threads) {
+    for(auto&& buffer : write_parallel(values, format, threads)) {
+        out.write(buffer.data(), buffer.size());
+    }
+}
+
+void from_json(std::istream& in, Definition &v) {
+    std::string document;
+    json::extract_document(in, document);
+    from_json(std::string_view(document), v);
+}
+
+void from_json(std::string_view in, Definition &v) {
+    json::parse(in, v);
+}
+
+void from_json(std::span<const std::byte> in, Definition &v) {
+    from_json(std::string_view(reinterpret_cast<const char*>(in.data()), in.size()), v);
+}
+
+void from_json_reuse(std::string_view in, Definition &v) {
+    json::parse(in, v, true);
+}
+
+void from_json_file(const std::filesystem::path& path, Definition &v) {
+    mapped_file file(path);
+    json::parse(file.contents(), v);
+}
+
+std::size_t for_each_json_record(const std::filesystem::path& path, const std::function<void(const Definition&)>& f) {
+    mapped_file file(path);
+    return json_record_reader<Definition>(file.contents()).for_each(f);
+}
+
+void from_json_records_parallel(std::string_view in, std::vector<Definition>& records, unsigned threads) {
+    json::parse_records_parallel(in, records, threads);
+}
+
+void from_json_file_parallel(const std::filesystem::path& path, std::vector<Definition>& records, unsigned threads) {
+    mapped_file file(path);
+    json::parse_records_parallel(file.contents(), records, threads);
+}
+
+std::size_t for_each_json_record_parallel(std::string_view in, const std::function<void(unsigned worker, const Definition&)>& f, unsigned threads) {
+    return json::for_each_record_parallel<Definition>(in, f, threads);
+}
+
+bool next_json_record(json_record_source& source, Definition &v) {
+    return json::next_record(source, v);
+}
+
+DefinitionView::DefinitionView(std::string_view json)
+  : d_json(json) {
+    // qualified, a member of the view may be called tag
+    json::index_object(json, d_members, [](std::string_view key) { return key_index(key, valuetypes::tag<Definition>{}); });
+}
+
+std::string DefinitionView::name() const {
+    auto in = d_members[0];
+    return json::decode<std::string>(in);
+}
+
+json_array_view<MemberView> DefinitionView::members() const {
+    auto in = d_members[1];
+    return json::decode<json_array_view<MemberView>>(in);
+}
+
+bool DefinitionView::immutable() const {
+    auto in = d_members[2];
+    if(in.empty()) {
+        return { false };
+    }
+    return json::decode<bool>(in);
+}
+
+Definition DefinitionView::to_value() const {
+    Definition v{};
+    if(!d_json.empty()) {
+        json::parse(d_json, v);
+    }
+    return v;
+}
+
+void to_json(std::string& out, const DefinitionStore &v) {
+    json_writer writer(out);
+    write(writer, v);
+}
+
+std::string to_json_string(const DefinitionStore &v) {
+    std::string out;
+    out.reserve(measure(v));
+    to_json(out, v);
+    return out;
+}
+
+std::size_t json_size(const DefinitionStore &v) noexcept {
+    return measure(v);
+}
+
+void to_json(std::ostream& out, const DefinitionStore &v) {
+    // reuse the buffer between calls, but let go of the memory of an
+    // unusually large value rather than keep it for the life of the thread
+    constexpr std::size_t max_kept_capacity = 64 * 1024;
+    thread_local std::string buffer;
+    buffer.clear();
+    to_json(buffer, v);
+    out.write(buffer.data(), buffer.size());
+    if(buffer.capacity() > max_kept_capacity) {
+        std::string().swap(buffer);
+    }
+}
+
+void to_json_parallel(std::span<const DefinitionStore> values, std::string& out, json_record_format format, unsigned threads) {
+    auto buffers = write_parallel(values, format, threads);
+
+    std::size_t size = out.size();
+    for(auto&& buffer : buffers) {
+        size += buffer.size();
+    }
+    out.reserve(size);
+    for(auto&& buffer : buffers) {
+        out.append(buffer);
+    }
+}
+
+void to_json_parallel(std::span<const DefinitionStore> values, std::ostream& out, json_record_format format, unsigned threads) {
+    for(auto&& buffer : write_parallel(values, format, threads)) {
+        out.write(buffer.data(), buffer.size());
+    }
+}
+
+void from_json(std::istream& in, DefinitionStore &v) {
+    std::string document;
+    json::extract_document(in, document);
+    from_json(std::string_view(document), v);
+}
+
+void from_json(std::string_view in, DefinitionStore &v) {
+    json::parse(in, v);
+}
+
+void from_json(std::span<const std::byte> in, DefinitionStore &v) {
+    from_json(std::string_view(reinterpret_cast<const char*>(in.data()), in.size()), v);
+}
+
+void from_json_reuse(std::string_view in, DefinitionStore &v) {
+    json::parse(in, v, true);
+}
+
+void from_json_file(const std::filesystem::path& path, DefinitionStore &v) {
+    mapped_file file(path);
+    json::parse(file.contents(), v);
+}
+
+std::size_t for_each_json_record(const std::filesystem::path& path, const std::function<void(const DefinitionStore&)>& f) {
+    mapped_file file(path);
+    return json_record_reader<DefinitionStore>(file.contents()).for_each(f);
+}
+
+void from_json_records_parallel(std::string_view in, std::vector<DefinitionStore>& records, unsigned threads) {
+    json::parse_records_parallel(in, records, threads);
+}
+
+void from_json_file_parallel(const std::filesystem::path& path, std::vector<DefinitionStore>& records, unsigned threads) {
+    mapped_file file(path);
+    json::parse_records_parallel(file.contents(), records, threads);
+}
+
+std::size_t for_each_json_record_parallel(std::string_view in, const std::function<void(unsigned worker, const DefinitionStore&)>& f, unsigned threads) {
+    return json::for_each_record_parallel<DefinitionStore>(in, f, threads);
+}
+
+bool next_json_record(json_record_source& source, DefinitionStore &v) {
+    return json::next_record(source, v);
+}
+
+DefinitionStoreView::DefinitionStoreView(std::string_view json)
+  : d_json(json) {
+    // qualified, a member of the view may be called tag
+    json::index_object(json, d_members, [](std::string_view key) { return key_index(key, valuetypes::tag<DefinitionStore>{}); });
+}
+
+std::optional<std::string> DefinitionStoreView::ns() const {
+    auto in = d_members[0];
+    return json::decode<std::optional<std::string>>(in);
+}
+
+json_array_view<DefinitionView> DefinitionStoreView::types() const {
+    auto in = d_members[1];
+    return json::decode<json_array_view<DefinitionView>>(in);
+}
+
+DefinitionStore DefinitionStoreView::to_value() const {
+    DefinitionStore v{};
+    if(!d_json.empty()) {
+        json::parse(d_json, v);
+    }
+    return v;
+}
+
+} // namespace valuetypes
+
+namespace std {
+
+std::ostream &operator<<(std::ostream& out, const valuetypes::TemplateParameter &v) {
+    valuetypes::to_json(out, v);
+    return out;
+}
+
+std::istream &operator>>(std::istream& in, valuetypes::TemplateParameter &v) {
+    valuetypes::from_json(in, v);
+    return in;
+}
+
+std::ostream &operator<<(std::ostream& out, const valuetypes::Member &v) {
+    valuetypes::to_json(out, v);
+    return out;
+}
+
+std::istream &operator>>(std::istream& in, valuetypes::Member &v) {
+    valuetypes::from_json(in, v);
+    return in;
+}
+
+std::ostream &operator<<(std::ostream& out, const valuetypes::Definition &v) {
+    valuetypes::to_json(out, v);
+    return out;
+}
+
+std::istream &operator>>(std::istream& in, valuetypes::Definition &v) {
+    valuetypes::from_json(in, v);
+    return in;
+}
+
+std::ostream &operator<<(std::ostream& out, const valuetypes::DefinitionStore &v) {
+    valuetypes::to_json(out, v);
+    return out;
+}
+
+std::istream &operator>>(std::istream& in, valuetypes::DefinitionStore &v) {
+    valuetypes::from_json(in, v);
+    return in;
+}
+
+} // namespace std
+
+// end iostream_definitions.cpp.inja
+
+// start hash_definitions.cpp.inja
+
+namespace valuetypes { 
+namespace {
+namespace hashing {
+
+/*
+ * Hashing in the style of wyhash: every value is folded into a 64 bit state
+ * with a 64x64->128 bit multiply whose halves are xored together, which
+ * spreads each input bit over the whole state in a few cycles. Strings, and
+ * sequences of values whose equal values have equal bytes, are hashed as one
+ * contiguous range of bytes rather than element by element.
+ */
+
+constexpr std::uint64_t secret[4] = {0xa0761d6478bd642f, 0xe7037ed1a0b428db, 0x8ebc6af09c88c6e3, 0x589965cc75374cc3};
+
+void multiply(std::uint64_t& a, std::uint64_t& b) noexcept {
+    // a and b become the low and the high half of their product
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef unsigned __int128 uint128;
+
+    uint128 r = static_cast<uint128>(a) * b;
+    a         = static_cast<std::uint64_t>(r);
+    b         = static_cast<std::uint64_t>(r >> 64);
+#else
+    std::uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<std::uint32_t>(a), lb = static_cast<std::uint32_t>(b);
+    std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    std::uint64_t t  = rl + (rm0 << 32);
+    std::uint64_t lo = t + (rm1 << 32);
+    a                = lo;
+    b                = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+#endif
+}
+
+std::uint64_t mix(std::uint64_t a, std::uint64_t b) noexcept {
+    multiply(a, b);
+    return a ^ b;
+}
+
+std::uint64_t read8(const unsigned char* p) noexcept {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+std::uint64_t read4(const unsigned char* p) noexcept {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+[[maybe_unused]] std::uint64_t bytes(std::uint64_t seed, const void* data, std::size_t size) noexcept {
+    auto          p = static_cast<const unsigned char*>(data);
+    std::uint64_t a = 0;
+    std::uint64_t b = 0;
+    seed ^= mix(seed ^ secret[0], secret[1]);
+    if(size <= 16) {
+        if(size >= 4) {
+            // two overlapping reads cover 4 to 16 bytes
+            auto middle = (size >> 3) << 2;
+            a           = (read4(p) << 32) | read4(p + middle);
+            b           = (read4(p + size - 4) << 32) | read4(p + size - 4 - middle);
+        } else if(size > 0) {
+            a = (std::uint64_t(p[0]) << 16) | (std::uint64_t(p[size >> 1]) << 8) | p[size - 1];
+        }
+    } else {
+        auto rest = size;
+        if(rest > 48) {
+            // three independent lanes keep the multipliers busy
+            auto seed1 = seed;
+            auto seed2 = seed;
+            do {
+                seed  = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+                seed1 = mix(read8(p + 16) ^ secret[2], read8(p + 24) ^ seed1);
+                seed2 = mix(read8(p + 32) ^ secret[3], read8(p + 40) ^ seed2);
+                p += 48;
+                rest -= 48;
+            } while(rest > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while(rest > 16) {
+            seed = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+            p += 16;
+            rest -= 16;
+        }
+        // the last 16 bytes, which may overlap the ones already read
+        a = read8(p + rest - 16);
+        b = read8(p + rest - 8);
+    }
+    a ^= secret[1];
+    b ^= seed;
+    multiply(a, b);
+    return mix(a ^ secret[0] ^ size, b ^ secret[1]);
+}
+
+std::uint64_t integer(std::uint64_t seed, std::uint64_t v) noexcept {
+    return mix(seed ^ secret[0], v ^ secret[1]);
+}
+
+template <typename T>
+std::uint64_t add(std::uint64_t seed, const T& v) noexcept {
+    // T is a member type, or the type of an element or alternative of one
+    if constexpr(std::is_integral_v<T>) {
+        return integer(seed, static_cast<std::uint64_t>(v));
+    } else if constexpr(std::is_same_v<double, T>) {
+        // 0.0 == -0.0, so they have to hash the same
+        return integer(seed, std::bit_cast<std::uint64_t>(v == 0 ? 0.0 : v));
+    } else if constexpr(std::is_same_v<float, T>) {
+        return integer(seed, std::bit_cast<std::uint32_t>(v == 0 ? 0.0f : v));
+    } else if constexpr(std::has_unique_object_representations_v<T>) {
+        // equal values have equal bytes: fixed_strings, whose unused chars
+        // are zero, arrays of integers, and structs of those without padding
+        return bytes(seed, std::addressof(v), sizeof(T));
+    } else if constexpr(is_string_v<T>) {
+        return bytes(seed, v.data(), v.size());
+    } else if constexpr(is_optional_v<T>) {
+        seed = integer(seed, v.has_value());
+        return v ? add(seed, *v) : seed;
+    } else if constexpr(is_variant_v<T>) {
+        seed = integer(seed, v.index());
+        if(v.valueless_by_exception()) {
+            return seed;
+        }
+        return std::visit([seed](auto&& a) { return add(seed, a); }, v);
+    } else if constexpr(is_vector_v<T> || is_std_array_v<T>) {
+        using E = typename T::value_type;
+        // std::vector<bool> packs its elements into bits
+        if constexpr(std::has_unique_object_representations_v<E> && !std::is_same_v<bool, E>) {
+            return bytes(seed, v.data(), v.size() * sizeof(E));
+        } else {
+            seed = integer(seed, v.size());
+            for(auto&& item : v) {
+                seed = add(seed, item);
+            }
+            return seed;
+        }
+    } else {
+        return integer(seed, std::hash<T>()(v));
+    }
+}
+
+template <typename... Ts>
+std::size_t combine(const Ts&... members) noexcept {
+    std::uint64_t seed = 0;
+    ((seed = add(seed, members)), ...);
+    return static_cast<std::size_t>(seed);
+}
+
+} // namespace hashing
+} // namespace
+} // namespace valuetypes
+
+namespace std {
+
 std::size_t hash<valuetypes::TemplateParameter>::operator()(const valuetypes::TemplateParameter &v) const noexcept {
-    return hash_combine(v.type, v.optional, v.name);
+    return valuetypes::hashing::combine(v.type, v.optional, v.name, v.capacity);
 }
 
 std::size_t hash<valuetypes::Member>::operator()(const valuetypes::Member &v) const noexcept {
-    return hash_combine(v.name, v.type, v.default_value, v.optional, v.value_type, v.value_types);
+    return valuetypes::hashing::combine(v.name, v.type, v.default_value, v.optional, v.capacity, v.size, v.value_type, v.value_types);
 }
 
 std::size_t hash<valuetypes::Definition>::operator()(const valuetypes::Definition &v) const noexcept {
-    return hash_combine(v.name, v.members);
+    return valuetypes::hashing::combine(v.name, v.members, v.immutable);
 }
 
 std::size_t hash<valuetypes::DefinitionStore>::operator()(const valuetypes::DefinitionStore &v) const noexcept {
-    return hash_combine(v.ns, v.types);
+    return valuetypes::hashing::combine(v.ns, v.types);
 }
 
 } // namespace std
 
 // end hash_definitions.cpp.inja
+
 // start swap_definitions.cpp.inja
 
 namespace std {
@@ -740,6 +3113,7 @@ void swap(valuetypes::TemplateParameter &a, valuetypes::TemplateParameter &b) no
     swap(a.type, b.type);
     swap(a.optional, b.optional);
     swap(a.name, b.name);
+    swap(a.capacity, b.capacity);
 }
 
 void swap(valuetypes::Member &a, valuetypes::Member &b) noexcept {
@@ -747,6 +3121,8 @@ void swap(valuetypes::Member &a, valuetypes::Member &b) noexcept {
     swap(a.type, b.type);
     swap(a.default_value, b.default_value);
     swap(a.optional, b.optional);
+    swap(a.capacity, b.capacity);
+    swap(a.size, b.size);
     swap(a.value_type, b.value_type);
     swap(a.value_types, b.value_types);
 }
@@ -754,6 +3130,7 @@ void swap(valuetypes::Member &a, valuetypes::Member &b) noexcept {
 void swap(valuetypes::Definition &a, valuetypes::Definition &b) noexcept {
     swap(a.name, b.name);
     swap(a.members, b.members);
+    swap(a.immutable, b.immutable);
 }
 
 void swap(valuetypes::DefinitionStore &a, valuetypes::DefinitionStore &b) noexcept {
@@ -1,12 +1,19 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <filesystem>
 #include <functional>
 #include <iosfwd>
-#include <string>
+#include <iterator>
 #include <optional>
-#include <vector>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <variant>
+#include <vector>
 
 namespace valuetypes { 
 
@@ -14,6 +21,7 @@ struct TemplateParameter {
     std::string type {  } ;
     bool optional { false } ;
     std::optional<std::string> name {  } ;
+    std::optional<unsigned int> capacity {  } ;
 };
 
 struct Member {
@@ -21,6 +29,8 @@ struct Member {
     std::string type {  } ;
     std::optional<std::string> default_value {  } ;
     bool optional { false } ;
+    std::optional<unsigned int> capacity {  } ;
+    std::optional<unsigned int> size {  } ;
     std::optional<TemplateParameter> value_type {  } ;
     std::optional<std::vector<TemplateParameter>> value_types {  } ;
 };
@@ -28,6 +38,7 @@ struct Member {
 struct Definition {
     std::string name {  } ;
     std::vector<Member> members {  } ;
+    bool immutable { false } ;
 };
 
 struct DefinitionStore {
@@ -69,21 +80,375 @@ bool operator>(const DefinitionStore &a, const DefinitionStore &b) noexcept;
 bool operator>=(const DefinitionStore &a, const DefinitionStore &b) noexcept;
 
 
+
+} // namespace valuetypes
+
+// shared between all generated libraries, which may use the same namespace
+#ifndef VALUETYPES_JSON_RECORDS
+#define VALUETYPES_JSON_RECORDS
+namespace valuetypes {
+
+enum class json_record_format {
+    array, // a top level json array
+    lines, // newline delimited json
+};
+
+struct json_record_source {
+    // Position in a newline delimited json document or a top level json
+    // array, see json_record_reader.
+    enum class framing { start, values, first_element, elements, end };
+
+    const char*   pos{nullptr};
+    const char*   end{nullptr};
+    std::istream* stream{nullptr};
+    std::string   document; // the current record when reading from a stream
+    framing       state{framing::start};
+};
+
+template <typename T>
+class json_record_reader {
+    // Reads the records of a newline delimited json document, or the elements
+    // of a top level json array, one at a time. A buffer is parsed in place,
+    // a stream is read one record at a time into a reused buffer, so memory
+    // use does not depend on the size of the input.
+  public:
+    class iterator {
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const T*;
+        using reference         = const T&;
+
+        iterator() noexcept = default;
+
+        explicit iterator(json_record_reader& reader)
+          : d_reader(&reader) {
+            ++*this;
+        }
+
+        reference operator*() const noexcept {
+            return d_reader->d_record;
+        }
+
+        pointer operator->() const noexcept {
+            return &d_reader->d_record;
+        }
+
+        iterator& operator++() {
+            if(!d_reader->next(d_reader->d_record)) {
+                d_reader = nullptr;
+            }
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        friend bool operator==(const iterator&, const iterator&) noexcept = default;
+
+      private:
+        json_record_reader* d_reader{nullptr};
+    };
+
+    explicit json_record_reader(std::string_view in) noexcept {
+        d_source.pos = in.data();
+        d_source.end = in.data() + in.size();
+    }
+
+    explicit json_record_reader(std::istream& in) noexcept {
+        d_source.stream = &in;
+    }
+
+    // Parses the next record into target, reusing its storage. Returns false at
+    // the end of the input.
+    bool next(T& target) {
+        return next_json_record(d_source, target);
+    }
+
+    // Calls f for every remaining record, returns the number of records.
+    template <typename F>
+    std::size_t for_each(F&& f) {
+        std::size_t count = 0;
+        while(next(d_record)) {
+            f(std::as_const(d_record));
+            ++count;
+        }
+        return count;
+    }
+
+    iterator begin() {
+        return iterator(*this);
+    }
+
+    iterator end() noexcept {
+        return {};
+    }
+
+  private:
+    json_record_source d_source;
+    T                  d_record{};
+};
+
+template <typename E>
+class json_array_view {
+    // The elements of a json array, decoded one at a time while iterating.
+    // Refers to the json text, which has to outlive the view.
+  public:
+    using value_type = E;
+    using next_fn    = std::string_view (*)(std::string_view& rest);
+    using decode_fn  = E (*)(std::string_view element);
+
+    class iterator {
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = E;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = E;
+
+        iterator() noexcept = default;
+
+        iterator(std::string_view elements, next_fn next, decode_fn decode)
+          : d_rest(elements)
+          , d_next(next)
+          , d_decode(decode) {
+            ++*this;
+        }
+
+        reference operator*() const {
+            return d_decode(d_current);
+        }
+
+        iterator& operator++() {
+            d_current = d_next(d_rest);
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) noexcept {
+            return a.d_current.data() == b.d_current.data();
+        }
+
+      private:
+        std::string_view d_current;
+        std::string_view d_rest;
+        next_fn          d_next{nullptr};
+        decode_fn        d_decode{nullptr};
+    };
+
+    json_array_view() noexcept = default;
+
+    json_array_view(std::string_view elements, next_fn next, decode_fn decode) noexcept
+      : d_elements(elements)
+      , d_next(next)
+      , d_decode(decode) {}
+
+    iterator begin() const {
+        return empty() ? iterator() : iterator(d_elements, d_next, d_decode);
+    }
+
+    iterator end() const noexcept {
+        return {};
+    }
+
+    bool empty() const noexcept {
+        return d_elements.empty();
+    }
+
+    // counts by skipping over the elements, without decoding them
+    std::size_t size() const {
+        std::size_t      n    = 0;
+        std::string_view rest = d_elements;
+        while(!rest.empty() && d_next(rest).data() != nullptr) {
+            ++n;
+        }
+        return n;
+    }
+
+    std::vector<E> to_vector() const {
+        return std::vector<E>(begin(), end());
+    }
+
+  private:
+    std::string_view d_elements; // the text between the brackets
+    next_fn          d_next{nullptr};
+    decode_fn        d_decode{nullptr};
+};
+
 } // namespace valuetypes
+#endif
 
 namespace valuetypes { 
 
+using valuetypes::json_array_view;
+using valuetypes::json_record_format;
+using valuetypes::json_record_reader;
+using valuetypes::json_record_source;
+
 void to_json(std::ostream& out, const TemplateParameter &v);
+void to_json(std::string& out, const TemplateParameter &v);
+std::string to_json_string(const TemplateParameter &v);
+void to_json_parallel(std::span<const TemplateParameter> values, std::string& out, json_record_format format = json_record_format::array, unsigned threads = 0);
+void to_json_parallel(std::span<const TemplateParameter> values, std::ostream& out, json_record_format format = json_record_format::array, unsigned threads = 0);
+std::size_t json_size(const TemplateParameter &v) noexcept;
 void from_json(std::istream& in, TemplateParameter &v);
+void from_json(std::string_view in, TemplateParameter &v);
+void from_json(std::span<const std::byte> in, TemplateParameter &v);
+void from_json_reuse(std::string_view in, TemplateParameter &v);
+void from_json_file(const std::filesystem::path& path, TemplateParameter &v);
+std::size_t for_each_json_record(const std::filesystem::path& path, const std::function<void(const TemplateParameter&)>& f);
+void from_json_records_parallel(std::string_view in, std::vector<TemplateParameter>& records, unsigned threads = 0);
+void from_json_file_parallel(const std::filesystem::path& path, std::vector<TemplateParameter>& records, unsigned threads = 0);
+std::size_t for_each_json_record_parallel(std::string_view in, const std::function<void(unsigned worker, const TemplateParameter&)>& f, unsigned threads = 0);
+bool next_json_record(json_record_source& source, TemplateParameter &v);
 
 void to_json(std::ostream& out, const Member &v);
+void to_json(std::string& out, const Member &v);
+std::string to_json_string(const Member &v);
+void to_json_parallel(std::span<const Member> values, std::string& out, json_record_format format = json_record_format::array, unsigned threads = 0);
+void to_json_parallel(std::span<const Member> values, std::ostream& out, json_record_format format = json_record_format::array, unsigned threads = 0);
+std::size_t json_size(const Member &v) noexcept;
 void from_json(std::istream& in, Member &v);
+void from_json(std::string_view in, Member &v);
+void from_json(std::span<const std::byte> in, Member &v);
+void from_json_reuse(std::string_view in, Member &v);
+void from_json_file(const std::filesystem::path& path, Member &v);
+std::size_t for_each_json_record(const std::filesystem::path& path, const std::function<void(const Member&)>& f);
+void from_json_records_parallel(std::string_view in, std::vector<Member>& records, unsigned threads = 0);
+void from_json_file_parallel(const std::filesystem::path& path, std::vector<Member>& records, unsigned threads = 0);
+std::size_t for_each_json_record_parallel(std::string_view in, const std::function<void(unsigned worker, const Member&)>& f, unsigned threads = 0);
+bool next_json_record(json_record_source& source, Member &v);
 
 void to_json(std::ostream& out, const Definition &v);
+void to_json(std::string& out, const Definition &v);
+std::string to_json_string(const Definition &v);
+void to_json_parallel(std::span<const Definition> values, std::string& out, json_record_format format = json_record_format::array, unsigned threads = 0);
+void to_json_parallel(std::span<const Definition> values, std::ostream& out, json_record_format format = json_record_format::array, unsigned threads = 0);
+std::size_t json_size(const Definition &v) noexcept;
 void from_json(std::istream& in, Definition &v);
+void from_json(std::string_view in, Definition &v);
+void from_json(std::span<const std::byte> in, Definition &v);
+void from_json_reuse(std::string_view in, Definition &v);
+void from_json_file(const std::filesystem::path& path, Definition &v);
+std::size_t for_each_json_record(const std::filesystem::path& path, const std::function<void(const Definition&)>& f);
+void from_json_records_parallel(std::string_view in, std::vector<Definition>& records, unsigned threads = 0);
+void from_json_file_parallel(const std::filesystem::path& path, std::vector<Definition>& records, unsigned threads = 0);
+std::size_t for_each_json_record_parallel(std::string_view in, const std::function<void(unsigned worker, const Definition&)>& f, unsigned threads = 0);
+bool next_json_record(json_record_source& source, Definition &v);
 
 void to_json(std::ostream& out, const DefinitionStore &v);
+void to_json(std::string& out, const DefinitionStore &v);
+std::string to_json_string(const DefinitionStore &v);
+void to_json_parallel(std::span<const DefinitionStore> values, std::string& out, json_record_format format = json_record_format::array, unsigned threads = 0);
+void to_json_parallel(std::span<const DefinitionStore> values, std::ostream& out, json_record_format format = json_record_format::array, unsigned threads = 0);
+std::size_t json_size(const DefinitionStore &v) noexcept;
 void from_json(std::istream& in, DefinitionStore &v);
+void from_json(std::string_view in, DefinitionStore &v);
+void from_json(std::span<const std::byte> in, DefinitionStore &v);
+void from_json_reuse(std::string_view in, DefinitionStore &v);
+void from_json_file(const std::filesystem::path& path, DefinitionStore &v);
+std::size_t for_each_json_record(const std::filesystem::path& path, const std::function<void(const DefinitionStore&)>& f);
+void from_json_records_parallel(std::string_view in, std::vector<DefinitionStore>& records, unsigned threads = 0);
+void from_json_file_parallel(const std::filesystem::path& path, std::vector<DefinitionStore>& records, unsigned threads = 0);
+std::size_t for_each_json_record_parallel(std::string_view in, const std::function<void(unsigned worker, const DefinitionStore&)>& f, unsigned threads = 0);
+bool next_json_record(json_record_source& source, DefinitionStore &v);
+
+class TemplateParameterView {
+    // TemplateParameter in json form, its members are only decoded when they
+    // are accessed. Refers to the json text, which has to outlive the view.
+  public:
+    TemplateParameterView() noexcept = default;
+    explicit TemplateParameterView(std::string_view json);
+
+    std::string type() const;
+    bool optional() const;
+    std::optional<std::string> name() const;
+    std::optional<unsigned int> capacity() const;
+
+    std::string_view json() const noexcept {
+        return d_json;
+    }
+
+    TemplateParameter to_value() const;
+
+  private:
+    std::string_view d_json;
+    std::array<std::string_view, 4> d_members; // the json text of each value, empty if absent
+};
+
+class MemberView {
+    // Member in json form, its members are only decoded when they
+    // are accessed. Refers to the json text, which has to outlive the view.
+  public:
+    MemberView() noexcept = default;
+    explicit MemberView(std::string_view json);
+
+    std::string name() const;
+    std::string type() const;
+    std::optional<std::string> default_value() const;
+    bool optional() const;
+    std::optional<unsigned int> capacity() const;
+    std::optional<unsigned int> size() const;
+    std::optional<TemplateParameterView> value_type() const;
+    std::optional<json_array_view<TemplateParameterView>> value_types() const;
+
+    std::string_view json() const noexcept {
+        return d_json;
+    }
+
+    Member to_value() const;
+
+  private:
+    std::string_view d_json;
+    std::array<std::string_view, 8> d_members; // the json text of each value, empty if absent
+};
+
+class DefinitionView {
+    // Definition in json form, its members are only decoded when they
+    // are accessed. Refers to the json text, which has to outlive the view.
+  public:
+    DefinitionView() noexcept = default;
+    explicit DefinitionView(std::string_view json);
+
+    std::string name() const;
+    json_array_view<MemberView> members() const;
+    bool immutable() const;
+
+    std::string_view json() const noexcept {
+        return d_json;
+    }
+
+    Definition to_value() const;
+
+  private:
+    std::string_view d_json;
+    std::array<std::string_view, 3> d_members; // the json text of each value, empty if absent
+};
+
+class DefinitionStoreView {
+    // DefinitionStore in json form, its members are only decoded when they
+    // are accessed. Refers to the json text, which has to outlive the view.
+  public:
+    DefinitionStoreView() noexcept = default;
+    explicit DefinitionStoreView(std::string_view json);
+
+    std::optional<std::string> ns() const;
+    json_array_view<DefinitionView> types() const;
+
+    std::string_view json() const noexcept {
+        return d_json;
+    }
+
+    DefinitionStore to_value() const;
+
+  private:
+    std::string_view d_json;
+    std::array<std::string_view, 2> d_members; // the json text of each value, empty if absent
+};
 
 
 } // namespace valuetypes
@@ -1,7 +1,7 @@
 #include "generate.h"
 #include "definitions/valuetypes.h"
 #include "render.h"
-#include <fstream>
+#include <iostream>
 #include <string>
 #include <string_view>
 
@@ -14,12 +14,19 @@ void generate(const Options& opts) {
     fs::create_directories(opts.output_dir);
 
     auto defs = [&] {
-        ifstream        file(opts.input_file);
         DefinitionStore ds;
-        from_json(file, ds);
+        from_json_file(opts.input_file, ds);
         return ds;
     }();
-    auto vars = transform(move(defs));
+    auto vars = transform(move(defs), opts);
+
+    if(opts.layout_report) {
+        for(auto&& def : vars["typedefs"]) {
+            auto& layout = def["layout"];
+            cout << def["namespace_name"].get<string>() << ": size " << layout["size"] << ", alignment "
+                 << layout["alignment"] << ", padding " << layout["padding"] << '\n';
+        }
+    }
 
     render(move(vars), opts);
 }
@@ -11,6 +11,14 @@ struct Options {
     std::filesystem::path output_dir;
     std::filesystem::path base_filename;
     bool                  json{false};
+    bool                  pmr{false};
+    bool                  binary{false};
+    bool                  flat{false};
+    bool                  msgpack{false};
+    bool                  cbor{false};
+    bool                  columns{false};
+    bool                  optimize_layout{false};
+    bool                  layout_report{false};
 };
 
 void generate(const Options& opts);
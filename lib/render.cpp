@@ -42,6 +42,13 @@ Variables opts_to_vars(const Options& opts) {
     d["library_name"]    = is_valid ? libname : string(opts.base_filename);
     d["base_filename"]   = opts.base_filename;
     d["json"]            = opts.json;
+    d["pmr"]             = opts.pmr;
+    d["binary"]          = opts.binary;
+    d["flat"]            = opts.flat;
+    d["msgpack"]         = opts.msgpack;
+    d["cbor"]            = opts.cbor;
+    d["columns"]         = opts.columns;
+    d["optimize_layout"] = opts.optimize_layout;
 
     return d;
 }
@@ -16,14 +16,26 @@ inja::Environment make_env() {
     inja::Environment env;
     env.set_search_included_templates_in_files(false);
 
+    include_template(env, "binary_declarations", binary_declarations());
+    include_template(env, "binary_definitions", binary_definitions());
+    include_template(env, "cbor_declarations", cbor_declarations());
+    include_template(env, "cbor_definitions", cbor_definitions());
+    include_template(env, "columns_declarations", columns_declarations());
+    include_template(env, "columns_definitions", columns_definitions());
     include_template(env, "comparison_declarations", comparison_declarations());
     include_template(env, "comparison_definitions", comparison_definitions());
     include_template(env, "equality_declarations", equality_declarations());
     include_template(env, "equality_definitions", equality_definitions());
+    include_template(env, "flat_declarations", flat_declarations());
+    include_template(env, "flat_definitions", flat_definitions());
     include_template(env, "hash_declarations", hash_declarations());
     include_template(env, "hash_definitions", hash_definitions());
+    include_template(env, "immutable_declarations", immutable_declarations());
+    include_template(env, "immutable_definitions", immutable_definitions());
     include_template(env, "iostream_declarations", iostream_declarations());
     include_template(env, "iostream_definitions", iostream_definitions());
+    include_template(env, "msgpack_declarations", msgpack_declarations());
+    include_template(env, "msgpack_definitions", msgpack_definitions());
     include_template(env, "swap_declarations", swap_declarations());
     include_template(env, "swap_definitions", swap_definitions());
 
@@ -32,6 +44,10 @@ inja::Environment make_env() {
 
 std::string_view cmakelists() noexcept {
     return R"(add_library({{ options.library_name }} {{ options.base_filename }}.h {{ options.base_filename }}.cpp)
+## if options.json
+find_package(Threads REQUIRED)
+target_link_libraries({{ options.library_name }} PUBLIC Threads::Threads)
+## endif
 )";
 }
 
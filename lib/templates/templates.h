@@ -11,18 +11,36 @@ std::string_view source() noexcept;
 
 inja::Environment make_env();
 
+std::string_view binary_declarations() noexcept;
+std::string_view binary_definitions() noexcept;
+
+std::string_view cbor_declarations() noexcept;
+std::string_view cbor_definitions() noexcept;
+
+std::string_view columns_declarations() noexcept;
+std::string_view columns_definitions() noexcept;
+
 std::string_view comparison_declarations() noexcept;
 std::string_view comparison_definitions() noexcept;
 
 std::string_view equality_declarations() noexcept;
 std::string_view equality_definitions() noexcept;
 
+std::string_view flat_declarations() noexcept;
+std::string_view flat_definitions() noexcept;
+
 std::string_view hash_declarations() noexcept;
 std::string_view hash_definitions() noexcept;
 
+std::string_view immutable_declarations() noexcept;
+std::string_view immutable_definitions() noexcept;
+
 std::string_view iostream_declarations() noexcept;
 std::string_view iostream_definitions() noexcept;
 
+std::string_view msgpack_declarations() noexcept;
+std::string_view msgpack_definitions() noexcept;
+
 std::string_view swap_declarations() noexcept;
 std::string_view swap_definitions() noexcept;
 
@@ -1,10 +1,16 @@
 #include "transform.h"
 #include <algorithm>
+#include <cstdint>
 #include <iomanip>
+#include <map>
+#include <memory_resource>
+#include <numeric>
+#include <set>
 #include <sstream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace valuetypes {
 
@@ -32,8 +38,54 @@ const unordered_map<string_view, string_view> one_to_one = {
     {"bool", "bool"},
     {"string", "std::string"},
     {"vector", "std::vector"},
+    {"array", "std::array"},
     {"variant", "std::variant"}};
 
+const unordered_map<string_view, string_view> pmr_allocating = {
+    {"string", "std::pmr::string"},
+    {"vector", "std::pmr::vector"}};
+
+struct Layout {
+    // the size and alignment of a type, as laid out on the platform the
+    // generator runs on
+    size_t size{0};
+    size_t alignment{1};
+};
+
+template <typename T>
+constexpr Layout layout_of() noexcept {
+    return {sizeof(T), alignof(T)};
+}
+
+const unordered_map<string_view, Layout> builtin_layouts = {
+    {"bool", layout_of<bool>()},
+    {"int", layout_of<int>()},
+    {"uint", layout_of<unsigned int>()},
+    {"int8", layout_of<int8_t>()},
+    {"uint8", layout_of<uint8_t>()},
+    {"int16", layout_of<int16_t>()},
+    {"uint16", layout_of<uint16_t>()},
+    {"int32", layout_of<int32_t>()},
+    {"uint32", layout_of<uint32_t>()},
+    {"int64", layout_of<int64_t>()},
+    {"uint64", layout_of<uint64_t>()},
+    {"float", layout_of<float>()},
+    {"double", layout_of<double>()},
+    {"string", layout_of<std::string>()},
+    {"vector", layout_of<std::vector<int>>()}};
+
+const unordered_map<string_view, Layout> pmr_layouts = {
+    {"string", layout_of<std::pmr::string>()},
+    {"vector", layout_of<std::pmr::vector<int>>()}};
+
+struct Types {
+    // what the type names in the definitions can refer to
+    unordered_set<string>         local_typedefs;
+    unordered_map<string, Layout> local_layouts;
+    bool                          pmr{false};
+    bool                          optimize_layout{false};
+};
+
 template <typename T>
 void fill_optional(Variables& vars, const char* key, const std::optional<T>& value) {
     if(value) {
@@ -51,30 +103,49 @@ string maybe_optionalize(bool should, string_view base) {
     return should ? optionalize(base) : string(base);
 }
 
-string validated_type(string_view type, const unordered_set<string>& local_typedefs) {
+string validated_type(string_view type, const Types& types) {
     if(auto it = int_like.find(type); it != int_like.end()) {
         return string(it->second);
     } else if(auto it = float_like.find(type); it != float_like.end()) {
         return string(it->second);
+    } else if(auto it = pmr_allocating.find(type); types.pmr && it != pmr_allocating.end()) {
+        return string(it->second);
     } else if(auto it = one_to_one.find(type); it != one_to_one.end()) {
         return string(it->second);
-    } else if(auto it = local_typedefs.find(string(type)); it != local_typedefs.end()) {
+    } else if(auto it = types.local_typedefs.find(string(type)); it != types.local_typedefs.end()) {
         return *it;
     } else {
         throw ValidationError(string("unrecognized type: ") + string(type));
     }
 };
 
-string real_type(const TemplateParameter& member, const unordered_set<string>& local_typedefs) {
-    string base = validated_type(member.type, local_typedefs);
+template <typename M>
+string base_type(const M& member, const Types& types) {
+    // M is a TemplateParameter or a Member
+    if(member.type == "fixed_string") {
+        if(!member.capacity || *member.capacity == 0) {
+            throw ValidationError("fixed_string needs a positive capacity");
+        }
+        return "fixed_string<" + to_string(*member.capacity) + ">";
+    }
+    return validated_type(member.type, types);
+}
+
+string real_type(const TemplateParameter& member, const Types& types) {
+    string base = base_type(member, types);
     return maybe_optionalize(member.optional, base);
 }
 
-string real_type(const Member& member, const unordered_set<string>& local_typedefs) {
-    string base = validated_type(member.type, local_typedefs);
+string real_type(const Member& member, const Types& types) {
+    string base = base_type(member, types);
 
-    if(member.value_type) {
-        base += string("<") + maybe_optionalize(member.value_type->optional, member.value_type->type) + ">";
+    if(member.type == "array") {
+        if(!member.value_type || !member.size) {
+            throw ValidationError("array needs a value_type and a size");
+        }
+        base += string("<") + real_type(*member.value_type, types) + ", " + to_string(*member.size) + ">";
+    } else if(member.value_type) {
+        base += string("<") + real_type(*member.value_type, types) + ">";
     } else if(member.value_types) {
         base += string("<");
 
@@ -83,7 +154,7 @@ string real_type(const Member& member, const unordered_set<string>& local_typede
             if(!first) {
                 base += ", ";
             }
-            base += real_type(vt, local_typedefs);
+            base += real_type(vt, types);
             first = false;
         }
         base += ">";
@@ -92,28 +163,238 @@ string real_type(const Member& member, const unordered_set<string>& local_typede
     return maybe_optionalize(member.optional, base);
 }
 
-Variables transform(const Member& member, const unordered_set<string>& local_typedefs) {
+template <typename M>
+string viewed_type(const M& member, const Types& types) {
+    string base = base_type(member, types);
+    if(types.local_typedefs.count(base)) {
+        base += "View";
+    }
+    return maybe_optionalize(member.optional, base);
+}
+
+string view_type(const Member& member, const Types& types) {
+    // the type a generated view returns for the member: nested structs are
+    // viewed rather than decoded, and vectors are decoded lazily while iterating.
+    // Arrays are small and decoded in one go.
+    if(member.type == "array") {
+        return real_type(member, types);
+    } else if(member.value_type && !member.value_types) {
+        string element = viewed_type(*member.value_type, types);
+        return maybe_optionalize(member.optional, "json_array_view<" + element + ">");
+    } else if(member.value_types) {
+        return real_type(member, types);
+    }
+    return viewed_type(member, types);
+}
+
+template <typename M>
+string flat_element_type(const M& member, const Types& types) {
+    string base = base_type(member, types);
+    if(types.local_typedefs.count(base)) {
+        base += "Flat";
+    } else if(member.type == "string" || member.type == "fixed_string") {
+        base = "std::string_view";
+    }
+    return maybe_optionalize(member.optional, base);
+}
+
+string flat_type(const Member& member, const Types& types) {
+    // the type a generated flat accessor returns for the member: strings and
+    // sequences refer into the buffer, nested structs are read in place
+    if(member.value_types) {
+        string base  = "std::variant<";
+        bool   first = true;
+        for(auto& vt : *member.value_types) {
+            if(!first) {
+                base += ", ";
+            }
+            base += flat_element_type(vt, types);
+            first = false;
+        }
+        return maybe_optionalize(member.optional, base + ">");
+    } else if(member.value_type) {
+        return maybe_optionalize(member.optional, "flat_vector<" + flat_element_type(*member.value_type, types) + ">");
+    }
+    return flat_element_type(member, types);
+}
+
+size_t round_up(size_t n, size_t alignment) {
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+Layout optional_layout(Layout value) {
+    // the value followed by the engaged flag
+    return {round_up(value.size + 1, value.alignment), value.alignment};
+}
+
+template <typename M>
+Layout base_layout(const M& member, const Types& types) {
+    // M is a TemplateParameter or a Member, already validated by base_type
+    if(member.type == "fixed_string") {
+        // the chars followed by the smallest unsigned type that holds the size
+        size_t capacity  = *member.capacity;
+        size_t size_type = capacity <= 0xff ? 1 : capacity <= 0xffff ? 2 : 4;
+        return {round_up(capacity + size_type, size_type), size_type};
+    } else if(auto it = pmr_layouts.find(member.type); types.pmr && it != pmr_layouts.end()) {
+        return it->second;
+    } else if(auto it = builtin_layouts.find(member.type); it != builtin_layouts.end()) {
+        return it->second;
+    } else if(auto it = types.local_layouts.find(member.type); it != types.local_layouts.end()) {
+        return it->second;
+    } else {
+        throw ValidationError(string("cannot lay out type: ") + member.type);
+    }
+}
+
+Layout layout(const TemplateParameter& member, const Types& types) {
+    auto base = base_layout(member, types);
+    return member.optional ? optional_layout(base) : base;
+}
+
+Layout layout(const Member& member, const Types& types) {
+    Layout base;
+    if(member.type == "array") {
+        auto element = layout(*member.value_type, types);
+        base         = *member.size ? Layout{element.size * *member.size, element.alignment} : Layout{1, 1};
+    } else if(member.value_types) {
+        // the largest alternative followed by the index, which is a single
+        // byte for any reasonable number of alternatives
+        for(auto& vt : *member.value_types) {
+            auto alternative = layout(vt, types);
+            base.size        = max(base.size, alternative.size);
+            base.alignment   = max(base.alignment, alternative.alignment);
+        }
+        base.size = round_up(base.size + 1, base.alignment);
+    } else {
+        base = base_layout(member, types);
+    }
+    return member.optional ? optional_layout(base) : base;
+}
+
+string escape_literal(string_view s, char quote) {
+    // escape for use in a C++ string or char literal
+    ostringstream stream;
+    for(char c : s) {
+        auto u = static_cast<unsigned char>(c);
+        if(c == quote || c == '\\') {
+            stream << '\\' << c;
+        } else if(u < 0x20 || u >= 0x7f) {
+            stream << '\\' << oct << setw(3) << setfill('0') << static_cast<unsigned>(u);
+        } else {
+            stream << c;
+        }
+    }
+    return stream.str();
+}
+
+string escape_json(string_view s) {
+    ostringstream stream;
+    for(char c : s) {
+        auto u = static_cast<unsigned char>(c);
+        if(c == '"' || c == '\\') {
+            stream << '\\' << c;
+        } else if(u < 0x20) {
+            stream << "\\u" << hex << setw(4) << setfill('0') << static_cast<unsigned>(u);
+        } else {
+            stream << c;
+        }
+    }
+    return stream.str();
+}
+
+string json_key(string_view name) {
+    // the '"name": ' prefix written in front of a member, as the contents of
+    // a C++ string literal
+    return escape_literal(string("\"") + escape_json(name) + "\": ", '"');
+}
+
+/*
+ * Builds the key lookup for a list of json keys: the keys are grouped by
+ * length, and within a group the first character position that tells all
+ * keys apart is picked. The generated lookup is then a switch on the length,
+ * a switch on that character, and a single comparison to reject unknown keys.
+ * Groups where no such position exists fall back to comparing each key.
+ */
+Variables key_dispatch(const vector<string>& keys) {
+    map<size_t, vector<size_t>> by_size;
+    for(size_t i = 0; i < keys.size(); ++i) {
+        by_size[keys[i].size()].push_back(i);
+    }
+
+    vector<Variables> groups;
+    for(auto&& [size, indices] : by_size) {
+        optional<size_t> position;
+        for(size_t p = 0; p < size && !position; ++p) {
+            set<char> seen;
+            for(auto i : indices) {
+                seen.insert(keys[i][p]);
+            }
+            if(seen.size() == indices.size()) {
+                position = p;
+            }
+        }
+
+        vector<Variables> candidates;
+        for(auto i : indices) {
+            Variables c;
+            c["index"]   = i;
+            c["literal"] = escape_literal(keys[i], '"');
+            if(position) {
+                c["char"] = "'" + escape_literal(keys[i].substr(*position, 1), '\'') + "'";
+            }
+            candidates.push_back(move(c));
+        }
+
+        Variables g;
+        g["size"]       = size;
+        g["switch"]     = position.has_value();
+        g["position"]   = position ? *position : 0;
+        g["candidates"] = move(candidates);
+        groups.push_back(move(g));
+    }
+
+    return groups;
+}
+
+Variables transform(const Member& member, const Types& types) {
     Variables vars;
 
-    vars["name"] = member.name;
-    vars["type"] = real_type(member, local_typedefs);
+    vars["name"]      = member.name;
+    vars["type"]      = real_type(member, types);
+    vars["view_type"] = view_type(member, types);
+    vars["flat_type"] = flat_type(member, types);
+    vars["json_key"]  = json_key(member.name);
+    // the name in a C++ string literal, for the binary formats with keys
+    vars["key_literal"] = escape_literal(member.name, '"');
+
+    // takes the allocator of the struct in its allocator-extended constructors
+    vars["allocator_aware"] = types.pmr && !member.optional && !member.value_types &&
+                              (pmr_allocating.count(member.type) || types.local_typedefs.count(member.type));
 
     if(member.value_types) {
         vector<Variables> vts;
         std::transform(member.value_types->begin(), member.value_types->end(), back_inserter(vts), [&](auto&& item) {
             Variables j;
-            auto      n = real_type(item, local_typedefs);
+            auto      n = real_type(item, types);
             j["type"]   = n;
             if(item.name) {
                 j["name"] = *item.name;
             } else {
                 j["name"] = n;
             }
+            j["json_key"]    = json_key(j["name"].get<string>());
+            j["key_literal"] = escape_literal(j["name"].get<string>(), '"');
 
             return j;
         });
 
-        vars["value_types"] = vts;
+        vector<string> names;
+        for(auto&& vt : vts) {
+            names.push_back(vt["name"]);
+        }
+
+        vars["value_types"]  = vts;
+        vars["key_dispatch"] = key_dispatch(names);
     } else {
         vars["value_types"] = nullptr;
     }
@@ -129,7 +410,11 @@ Variables transform(const Member& member, const unordered_set<string>& local_typ
         }
     }
 
-    if(default_value && member.type == "string") {
+    if(default_value && member.type == "fixed_string" && default_value->size() > *member.capacity) {
+        throw ValidationError("default_value longer than the fixed_string capacity: " + member.name);
+    }
+
+    if(default_value && (member.type == "string" || member.type == "fixed_string")) {
         ostringstream stream;
         stream << quoted(*default_value);
         default_value = stream.str();
@@ -140,31 +425,99 @@ Variables transform(const Member& member, const unordered_set<string>& local_typ
     return vars;
 }
 
-Variables transform(const Definition& def, const unordered_set<string>& local_typedefs) {
+Variables transform(const Definition& def, const Types& types) {
     Variables vars;
-    vars["name"] = def.name;
+    vars["name"]      = def.name;
+    vars["immutable"] = def.immutable;
 
     vector<Variables> members;
     std::transform(def.members.begin(), def.members.end(), back_inserter(members), [&](auto&& m) {
-        return transform(m, local_typedefs);
+        return transform(m, types);
     });
 
-    vars["members"] = move(members);
+    vector<string> names;
+    for(auto&& m : def.members) {
+        names.push_back(m.name);
+    }
+
+    /*
+     * The members are declared in the order of the definition, or with
+     * optimize_layout from the largest alignment down to the smallest. As the
+     * size of a type is a multiple of its alignment, that leaves no padding
+     * between members. Everything else, the json keys and the order of the
+     * comparisons and of the binary formats, follows the definition.
+     *
+     * The sizes and alignments are those of the platform running the
+     * generator. The generated header asserts that the chosen order leaves
+     * no padding on the platform it is compiled for, which catches both a
+     * target that lays things out differently and a wrong guess here.
+     */
+    vector<Layout> layouts;
+    for(auto&& m : def.members) {
+        layouts.push_back(layout(m, types));
+    }
+
+    vector<size_t> order(def.members.size());
+    iota(order.begin(), order.end(), 0);
+    if(types.optimize_layout) {
+        stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return layouts[a].alignment > layouts[b].alignment;
+        });
+    }
+
+    vector<Variables> declared_members;
+    size_t            offset = 0;
+    size_t            data   = 0;
+    Layout            result;
+    for(auto i : order) {
+        declared_members.push_back(members[i]);
+        offset           = round_up(offset, layouts[i].alignment) + layouts[i].size;
+        data             = data + layouts[i].size;
+        result.alignment = max(result.alignment, layouts[i].alignment);
+    }
+    result.size = max<size_t>(round_up(offset, result.alignment), 1);
+
+    vars["members"]          = move(members);
+    vars["declared_members"] = move(declared_members);
+    vars["key_dispatch"]     = key_dispatch(names);
+    vars["layout"]           = {{"size", result.size}, {"alignment", result.alignment}, {"padding", result.size - data}};
 
     return vars;
 }
 
+bool uses_type(const DefinitionStore& ds, string_view type) {
+    for(auto&& def : ds.types) {
+        for(auto&& m : def.members) {
+            if(m.type == type || (m.value_type && m.value_type->type == type)) {
+                return true;
+            }
+            if(m.value_types) {
+                for(auto&& vt : *m.value_types) {
+                    if(vt.type == type) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
 } // namespace
 
-Variables transform(DefinitionStore ds) {
+Variables transform(DefinitionStore ds, const Options& opts) {
     Variables vars;
     fill_optional(vars, "namespace", ds.ns);
+    vars["fixed_string"] = uses_type(ds, "fixed_string");
+    vars["immutable"]    = any_of(ds.types.begin(), ds.types.end(), [](auto&& def) { return def.immutable; });
 
-    vector<Variables>     defs;
-    unordered_set<string> local_typedefs;
+    vector<Variables> defs;
+    Types             types;
+    types.pmr             = opts.pmr;
+    types.optimize_layout = opts.optimize_layout;
 
     std::transform(ds.types.begin(), ds.types.end(), back_inserter(defs), [&](const Definition& def) {
-        auto var = transform(def, local_typedefs);
+        auto var = transform(def, types);
 
         if(ds.ns) {
             var["namespace_name"] = (*ds.ns) + "::" + def.name;
@@ -172,7 +525,8 @@ Variables transform(DefinitionStore ds) {
             var["namespace_name"] = def.name;
         }
 
-        local_typedefs.insert(def.name);
+        types.local_typedefs.insert(def.name);
+        types.local_layouts[def.name] = {var["layout"]["size"], var["layout"]["alignment"]};
 
         return var;
     });
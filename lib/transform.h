@@ -1,5 +1,6 @@
 #pragma once
 
+#include "generate.h"
 #include <definitions/valuetypes.h>
 #include <nlohmann/json.hpp>
 
@@ -11,6 +12,6 @@ class ValidationError : public std::runtime_error {
     using std::runtime_error::runtime_error;
 };
 
-Variables transform(DefinitionStore doc);
+Variables transform(DefinitionStore doc, const Options& opts);
 
 } // namespace valuetypes
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <arrays/valuetypes.h>
+#include <rapidcheck/gtest.h>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_set>
+
+namespace vt {
+namespace {
+
+using namespace std;
+
+static_assert(is_same_v<array<uint8_t, 4>, decltype(Arrays::rgba)>);
+static_assert(is_trivially_copyable_v<Segment>);
+
+TEST(Arrays, construction) {
+    Arrays a1{};
+
+    EXPECT_EQ((array<uint8_t, 4>{0, 0, 0, 0}), a1.rgba);
+    EXPECT_EQ((array<double, 3>{0.0, 0.0, 0.0}), a1.position);
+    EXPECT_FALSE(a1.names);
+
+    Arrays a2{{1, 2, 3, 4}, {1.0, 2.0, 3.0}, {{"a", nullopt}}};
+
+    EXPECT_EQ(4, a2.rgba[3]);
+    EXPECT_EQ("a", (*a2.names)[0]);
+}
+
+TEST(Arrays, json) {
+    Arrays a;
+    from_json(string_view(R"({ "rgba": [ 255, 128, 0, 1 ], "position": [ 1.5, -2, 3e2 ], "names": [ "a", null ] })"), a);
+
+    EXPECT_EQ((array<uint8_t, 4>{255, 128, 0, 1}), a.rgba);
+    EXPECT_EQ((array<double, 3>{1.5, -2.0, 300.0}), a.position);
+    ASSERT_TRUE(a.names);
+    EXPECT_EQ("a", (*a.names)[0]);
+    EXPECT_FALSE((*a.names)[1]);
+
+    Segment s;
+    from_json(string_view(R"({ "ends": [ { "x": 1, "y": 2 }, { "x": 3, "y": 4 } ] })"), s);
+
+    EXPECT_EQ(3.0f, s.ends[1].x);
+}
+
+TEST(Arrays, jsonRejectsWrongElementCounts) {
+    Arrays a;
+    EXPECT_THROW(from_json(string_view(R"({ "rgba": [ 1, 2, 3 ] })"), a), runtime_error);
+    EXPECT_THROW(from_json(string_view(R"({ "rgba": [ 1, 2, 3, 4, 5 ] })"), a), runtime_error);
+    EXPECT_THROW(from_json(string_view(R"({ "position": [] })"), a), runtime_error);
+}
+
+TEST(Arrays, view) {
+    SegmentView v(R"({ "ends": [ { "x": 1, "y": 2 }, { "x": 3, "y": 4 } ] })");
+
+    EXPECT_EQ(4.0f, v.ends()[1].y);
+}
+
+TEST(Arrays, comparison) {
+    Segment s1{{Vec2{1, 2}, Vec2{3, 4}}};
+    Segment s2{{Vec2{1, 2}, Vec2{3, 5}}};
+
+    EXPECT_EQ(s1, s1);
+    EXPECT_NE(s1, s2);
+    EXPECT_LT(s1, s2);
+}
+
+TEST(Arrays, hashIsUsableForContainers) {
+    Arrays a1{};
+    Arrays a2{{1, 2, 3, 4}};
+
+    unordered_set<Arrays> s{a1};
+
+    EXPECT_NE(s.end(), s.find(a1));
+    EXPECT_EQ(s.end(), s.find(a2));
+}
+
+TEST(Arrays, swap) {
+    Arrays a1{{1, 2, 3, 4}};
+    Arrays a2{{5, 6, 7, 8}};
+
+    swap(a1, a2);
+
+    EXPECT_EQ(5, a1.rgba[0]);
+    EXPECT_EQ(1, a2.rgba[0]);
+}
+
+RC_GTEST_PROP(Arrays, marshalling, (uint8_t r, uint8_t g, double x, string name)) {
+    Arrays a1{{r, g, r, g}, {x, -x, 0.0}, {{name, nullopt}}};
+
+    Arrays a2;
+    from_json(to_json_string(a1), a2);
+
+    RC_ASSERT(a1 == a2);
+}
+
+} // namespace
+} // namespace vt
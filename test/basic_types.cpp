@@ -1,6 +1,11 @@
 #include <basic_types/valuetypes.h>
+#include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <limits>
+#include <numeric>
 #include <rapidcheck/gtest.h>
+#include <span>
 #include <sstream>
 #include <unordered_set>
 
@@ -43,6 +48,459 @@ TEST(BasicTypes, json) {
     EXPECT_EQ("abc", bt.s);
 }
 
+TEST(BasicTypes, jsonFromBuffer) {
+    constexpr std::string_view input = R"({ "truth": true, "n": 1, "x": 2.0, "s": "abc" })";
+
+    BasicTypes bt1;
+    from_json(input, bt1);
+
+    EXPECT_EQ(true, bt1.truth);
+    EXPECT_EQ(1, bt1.n);
+    EXPECT_EQ(2.0, bt1.x);
+    EXPECT_EQ("abc", bt1.s);
+
+    BasicTypes bt2;
+    from_json(std::as_bytes(std::span(input.data(), input.size())), bt2);
+
+    EXPECT_EQ(bt1, bt2);
+}
+
+TEST(BasicTypes, jsonSkipsUnknownMembers) {
+    constexpr std::string_view input = R"({
+    "a": { "b": [ 1, { "c": "]}" }, [] ], "d": "\"{[" },
+    "n": 1,
+    "e": [ -1.5e+3, true, false, null, "x\\" ],
+    "s": "abc",
+    "f": 12345678901234567890123,
+    "g": +5,
+    "h": [ +1.5, .5 ]
+})";
+    BasicTypes bt;
+    from_json(input, bt);
+
+    EXPECT_EQ((BasicTypes{false, 1, 0.0, "abc"}), bt);
+}
+
+TEST(BasicTypes, jsonSkipRejectsTruncatedValues) {
+    BasicTypes bt;
+    EXPECT_THROW(from_json(R"({ "a": [ { "b": 1 ] )", bt), std::runtime_error);
+    EXPECT_THROW(from_json(R"({ "a": "abc\" })", bt), std::runtime_error);
+    EXPECT_THROW(from_json(R"({ "a": [ "]" )", bt), std::runtime_error);
+}
+
+TEST(BasicTypes, view) {
+    BasicTypesView bt(R"({ "s": "abc", "unknown": [ "}" ], "n": 1 })");
+
+    EXPECT_EQ(1, bt.n());
+    EXPECT_EQ("abc", bt.s());
+    EXPECT_FALSE(bt.truth());
+    EXPECT_EQ(0.0, bt.x());
+
+    WithDefaultsView wd(R"({ "n": 7 })");
+    EXPECT_EQ(7, wd.n());
+    EXPECT_EQ("abc", wd.s());
+    EXPECT_EQ(456, wd.o());
+}
+
+TEST(BasicTypes, jsonReuse) {
+    BasicTypes bt{true, 1, 2.0, std::string(100, 'x')};
+    auto       data = bt.s.data();
+
+    from_json_reuse(R"({ "s": "abc", "n": 7 })", bt);
+
+    EXPECT_EQ((BasicTypes{false, 7, 0.0, "abc"}), bt);
+    EXPECT_EQ(data, bt.s.data());
+}
+
+TEST(BasicTypes, jsonReuseRestoresDefaults) {
+    WithDefaults wd{false, 1, 2.0, "xyz", std::nullopt};
+
+    from_json_reuse(R"({ "n": 7 })", wd);
+
+    WithDefaults e{};
+    e.n = 7;
+    EXPECT_EQ(e, wd);
+}
+
+TEST(BasicTypes, jsonEscapes) {
+    BasicTypes bt;
+    from_json(R"({ "s": "a\"b\\c\nd\u00e9\ud83d\ude00" })", bt);
+
+    EXPECT_EQ("a\"b\\c\nd\xc3\xa9\xf0\x9f\x98\x80", bt.s);
+}
+
+TEST(BasicTypes, jsonUnpairedSurrogates) {
+    BasicTypes bt;
+    EXPECT_THROW(from_json(R"({ "s": "\ud800A" })", bt), runtime_error);
+    EXPECT_THROW(from_json(R"({ "s": "\ud800\u0041" })", bt), runtime_error);
+    EXPECT_THROW(from_json(R"({ "s": "\udc00" })", bt), runtime_error);
+    EXPECT_THROW(from_json(R"({ "s": "\ud800" })", bt), runtime_error);
+}
+
+TEST(BasicTypes, jsonLongRuns) {
+    // long enough to exercise the vectorised scanning, with escapes landing on
+    // and around the block boundaries
+    string expect;
+    string escaped;
+    for(int i = 0; i < 200; ++i) {
+        char c = (i % 15 == 0 || i % 16 == 15) ? '"' : static_cast<char>('a' + i % 26);
+        expect += c;
+        if(c == '"') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+
+    string indent(70, ' ');
+    string input = "{" + indent + "\n\t\"s\"" + indent + ":" + indent + "\"" + escaped + "\"" + indent + "\r\n}";
+
+    BasicTypes bt;
+    from_json(input, bt);
+
+    EXPECT_EQ(expect, bt.s);
+}
+
+TEST(BasicTypes, jsonTrailingCharacters) {
+    BasicTypes bt;
+    EXPECT_THROW(from_json(R"({ "n": 1 } x)", bt), std::runtime_error);
+    EXPECT_THROW(from_json(R"({ "n": 1 )", bt), std::runtime_error);
+}
+
+TEST(BasicTypes, jsonStreamLeavesRemainder) {
+    istringstream stream(R"({ "n": 1 } { "n": 2 })");
+    BasicTypes    bt1, bt2;
+
+    stream >> bt1 >> bt2;
+
+    EXPECT_EQ(1, bt1.n);
+    EXPECT_EQ(2, bt2.n);
+}
+
+TEST(BasicTypes, jsonRecordsFromBuffer) {
+    json_record_reader<BasicTypes> reader("{ \"n\": 1 }\n{ \"n\": 2, \"s\": \"abc\" }\r\n\n{ \"n\": 3 }\n");
+
+    vector<BasicTypes> records;
+    for(auto&& record : reader) {
+        records.push_back(record);
+    }
+
+    EXPECT_EQ((vector<BasicTypes>{{false, 1, 0.0, ""}, {false, 2, 0.0, "abc"}, {false, 3, 0.0, ""}}), records);
+}
+
+TEST(BasicTypes, jsonRecordsFromArray) {
+    json_record_reader<BasicTypes> reader(R"([ { "n": 1 }, { "n": 2 } ])");
+
+    vector<int> ns;
+    EXPECT_EQ(2u, reader.for_each([&](const BasicTypes& bt) { ns.push_back(bt.n); }));
+    EXPECT_EQ((vector<int>{1, 2}), ns);
+
+    json_record_reader<BasicTypes> empty(" [ ] ");
+    BasicTypes                     bt;
+    EXPECT_FALSE(empty.next(bt));
+}
+
+TEST(BasicTypes, jsonRecordsFromStream) {
+    istringstream                  ndjson("{ \"n\": 1 }\n{ \"n\": 2 }\n");
+    json_record_reader<BasicTypes> ndjson_reader(ndjson);
+
+    istringstream                  array(R"([{ "n": 1 },{ "n": 2 }])");
+    json_record_reader<BasicTypes> array_reader(array);
+
+    BasicTypes bt;
+    for(auto* reader : {&ndjson_reader, &array_reader}) {
+        ASSERT_TRUE(reader->next(bt));
+        EXPECT_EQ(1, bt.n);
+        ASSERT_TRUE(reader->next(bt));
+        EXPECT_EQ(2, bt.n);
+        EXPECT_FALSE(reader->next(bt));
+    }
+}
+
+TEST(BasicTypes, jsonRecordsRejectMalformedArrays) {
+    BasicTypes bt;
+    for(string_view input : {R"([ { "n": 1 } { "n": 2 } ])", R"([ { "n": 1 }, )", R"([ { "n": 1 } ] x)"}) {
+        json_record_reader<BasicTypes> reader(input);
+        EXPECT_THROW(while(reader.next(bt)) {}, std::runtime_error) << input;
+    }
+}
+
+string many_records(int n) {
+    string input;
+    for(int i = 0; i < n; ++i) {
+        input += "{ \"n\": " + to_string(i) + ", \"s\": \"record " + to_string(i) + "\" }\n";
+    }
+    return input;
+}
+
+TEST(BasicTypes, jsonRecordsParallel) {
+    auto input = many_records(20000);
+
+    vector<BasicTypes> expect;
+    json_record_reader<BasicTypes>(input).for_each([&](const BasicTypes& bt) { expect.push_back(bt); });
+
+    for(unsigned threads : {1u, 3u, 8u}) {
+        vector<BasicTypes> records;
+        from_json_records_parallel(input, records, threads);
+        EXPECT_EQ(expect, records);
+    }
+}
+
+TEST(BasicTypes, jsonRecordsParallelFraming) {
+    // records spread over several lines, and the elements of an array, with
+    // braces and escapes inside strings
+    string pretty;
+    string array = "[";
+    for(int i = 0; i < 20000; ++i) {
+        pretty += "{\n  \"n\": " + to_string(i) + ",\n  \"s\": \"{\\\"\\n}\"\n}\n";
+        array += (i ? ",\n  { \"n\": " : "\n  { \"n\": ") + to_string(i) + ", \"s\": \"]}\" }";
+    }
+    array += "\n]\n";
+
+    for(auto&& input : {pretty, array}) {
+        vector<BasicTypes> expect;
+        json_record_reader<BasicTypes>(input).for_each([&](const BasicTypes& bt) { expect.push_back(bt); });
+        ASSERT_EQ(20000u, expect.size());
+
+        for(unsigned threads : {1u, 3u, 8u}) {
+            vector<BasicTypes> records;
+            from_json_records_parallel(input, records, threads);
+            EXPECT_EQ(expect, records);
+            EXPECT_EQ(20000u, for_each_json_record_parallel(input, [](unsigned, const BasicTypes&) {}, threads));
+        }
+    }
+
+    vector<BasicTypes> records;
+    from_json_records_parallel(" [ ] ", records);
+    EXPECT_TRUE(records.empty());
+    EXPECT_THROW(from_json_records_parallel("[ { \"n\": 1 } { \"n\": 2 } ]", records), std::runtime_error);
+    EXPECT_THROW(from_json_records_parallel("[ { \"n\": 1 }, ]", records), std::runtime_error);
+    EXPECT_THROW(from_json_records_parallel("[ { \"n\": 1 }", records), std::runtime_error);
+}
+
+TEST(BasicTypes, jsonRecordsParallelCallback) {
+    auto input = many_records(20000);
+
+    vector<long> sums(4, 0);
+    auto count = for_each_json_record_parallel(input, [&](unsigned worker, const BasicTypes& bt) { sums.at(worker) += bt.n; }, 4);
+
+    EXPECT_EQ(20000u, count);
+    EXPECT_EQ(19999L * 20000 / 2, std::accumulate(sums.begin(), sums.end(), 0L));
+}
+
+TEST(BasicTypes, jsonRecordsParallelErrors) {
+    auto input = many_records(20000) + "{ \"n\": x }\n" + many_records(100);
+
+    vector<BasicTypes> records;
+    EXPECT_THROW(from_json_records_parallel(input, records, 4), std::runtime_error);
+}
+
+TEST(BasicTypes, jsonParallelInsertion) {
+    vector<BasicTypes> values;
+    for(int i = 0; i < 5000; ++i) {
+        values.push_back({i % 2 == 0, i, i / 4.0, to_string(i)});
+    }
+
+    string expect;
+    for(auto&& v : values) {
+        expect += (expect.empty() ? "[ " : ", ") + to_json_string(v);
+    }
+    expect += "]";
+
+    for(unsigned threads : {1u, 3u}) {
+        string array;
+        to_json_parallel(values, array, json_record_format::array, threads);
+        EXPECT_EQ(expect, array);
+
+        ostringstream lines;
+        to_json_parallel(values, lines, json_record_format::lines, threads);
+
+        vector<BasicTypes> actual;
+        from_json_records_parallel(lines.str(), actual);
+        EXPECT_EQ(values, actual);
+    }
+
+    string empty;
+    to_json_parallel(std::span<const BasicTypes>(), empty);
+    EXPECT_EQ("[ ]", empty);
+}
+
+class BasicTypesFile : public ::testing::Test {
+  protected:
+    void TearDown() override {
+        std::filesystem::remove(d_path);
+    }
+
+    const std::filesystem::path& write(string_view contents) {
+        std::ofstream(d_path, std::ios::binary) << contents;
+        return d_path;
+    }
+
+  private:
+    std::filesystem::path d_path{std::filesystem::temp_directory_path() / "valuetypes_basic_types_test.json"};
+};
+
+TEST_F(BasicTypesFile, jsonFromFile) {
+    BasicTypes bt;
+    from_json_file(write(R"({ "truth": true, "n": 1, "x": 2.0, "s": "abc" })"), bt);
+
+    EXPECT_EQ((BasicTypes{true, 1, 2.0, "abc"}), bt);
+}
+
+TEST_F(BasicTypesFile, jsonRecordsFromFile) {
+    auto& path = write("{ \"n\": 1 }\n{ \"n\": 2 }\n");
+
+    vector<int> ns;
+    EXPECT_EQ(2u, for_each_json_record(path, [&](const BasicTypes& bt) { ns.push_back(bt.n); }));
+    EXPECT_EQ((vector<int>{1, 2}), ns);
+
+    EXPECT_EQ(0u, for_each_json_record(write(""), [](const BasicTypes&) {}));
+}
+
+TEST_F(BasicTypesFile, jsonFromMissingFile) {
+    BasicTypes bt;
+    EXPECT_THROW(from_json_file("/nonexistent/valuetypes.json", bt), std::filesystem::filesystem_error);
+}
+
+TEST(BasicTypes, integerLimits) {
+    AllInts ai;
+    from_json(R"({ "i": -2147483648, "u": 4294967295, "i8": -128, "u8": 255, "i16": -32768, "u16": 65535,
+                   "i32": 2147483647, "u32": 4294967295, "i64": -9223372036854775808, "u64": 18446744073709551615 })",
+              ai);
+
+    EXPECT_EQ(numeric_limits<int>::min(), ai.i);
+    EXPECT_EQ(numeric_limits<unsigned>::max(), ai.u);
+    EXPECT_EQ(-128, ai.i8);
+    EXPECT_EQ(255, ai.u8);
+    EXPECT_EQ(-32768, ai.i16);
+    EXPECT_EQ(65535, ai.u16);
+    EXPECT_EQ(numeric_limits<int32_t>::max(), ai.i32);
+    EXPECT_EQ(numeric_limits<uint32_t>::max(), ai.u32);
+    EXPECT_EQ(numeric_limits<int64_t>::min(), ai.i64);
+    EXPECT_EQ(numeric_limits<uint64_t>::max(), ai.u64);
+
+    from_json(R"({ "i8": 12, "u8": 7, "i64": 1234567890123456789, "u64": +12345678901234567890 })", ai);
+
+    EXPECT_EQ(12, ai.i8);
+    EXPECT_EQ(7, ai.u8);
+    EXPECT_EQ(1234567890123456789, ai.i64);
+    EXPECT_EQ(12345678901234567890u, ai.u64);
+}
+
+TEST(BasicTypes, integerOverflow) {
+    AllInts ai;
+    EXPECT_THROW(from_json(R"({ "i8": 128 })", ai), std::runtime_error);
+    EXPECT_THROW(from_json(R"({ "i8": -129 })", ai), std::runtime_error);
+    EXPECT_THROW(from_json(R"({ "u8": 256 })", ai), std::runtime_error);
+    EXPECT_THROW(from_json(R"({ "u8": -1 })", ai), std::runtime_error);
+    EXPECT_THROW(from_json(R"({ "i64": 9223372036854775808 })", ai), std::runtime_error);
+    EXPECT_THROW(from_json(R"({ "u64": 18446744073709551616 })", ai), std::runtime_error);
+    EXPECT_THROW(from_json(R"({ "u64": 111111111111111111111 })", ai), std::runtime_error);
+    EXPECT_THROW(from_json(R"({ "i": 1.5 })", ai), std::runtime_error);
+}
+
+RC_GTEST_PROP(BasicTypes, integerExtraction, (int n)) {
+    AllInts ai;
+    from_json("{ \"i64\": " + to_string(n) + ", \"i\": " + to_string(n) + " }", ai);
+
+    RC_ASSERT(ai.i64 == n);
+    RC_ASSERT(ai.i == n);
+}
+
+TEST(BasicTypes, floatExtraction) {
+    AllFloats af;
+    from_json(R"({ "f": 0.1, "d": 2.2250738585072014e-308 })", af);
+
+    EXPECT_EQ(0.1f, af.f);
+    EXPECT_EQ(2.2250738585072014e-308, af.d);
+
+    from_json(R"({ "f": -1e3, "d": 0.30000000000000004 })", af);
+
+    EXPECT_EQ(-1000.0f, af.f);
+    EXPECT_EQ(0.1 + 0.2, af.d);
+}
+
+TEST(BasicTypes, shortestFloats) {
+    ostringstream stream;
+    stream << AllFloats{0.1f, 0.1};
+
+    EXPECT_EQ(R"({ "f": 0.1, "d": 0.1})", stream.str());
+}
+
+TEST(BasicTypes, largeThenSmallToStream) {
+    // the stream buffer is released after a large value and made again
+    BasicTypes large{true, 1, 2.5, string(1 << 20, 'x')};
+    BasicTypes small{false, 2, 0.5, "y"};
+
+    ostringstream stream;
+    stream << large << small << small;
+
+    EXPECT_EQ(to_json_string(large) + to_json_string(small) + to_json_string(small), stream.str());
+}
+
+TEST(BasicTypes, smallIntsAreNumbers) {
+    AllInts ai1{};
+    ai1.i8 = -128;
+    ai1.u8 = 200;
+
+    stringstream stream;
+    stream << ai1;
+
+    AllInts ai2;
+    stream >> ai2;
+
+    EXPECT_EQ(ai1, ai2);
+}
+
+RC_GTEST_PROP(BasicTypes, floatMarshalling, (double d)) {
+    AllFloats af1{static_cast<float>(d), d};
+
+    stringstream stream;
+    stream << af1;
+
+    AllFloats af2;
+    stream >> af2;
+
+    RC_ASSERT(af1 == af2);
+}
+
+TEST(BasicTypes, jsonToString) {
+    BasicTypes bt{true, 1, 2.5, "a\"b\\c\nd\x01"};
+
+    auto s = to_json_string(bt);
+    EXPECT_EQ(R"({ "truth": true, "n": 1, "x": 2.5, "s": "a\"b\\c\nd\u0001"})", s);
+
+    string appended = "prefix";
+    to_json(appended, bt);
+    EXPECT_EQ("prefix" + s, appended);
+
+    BasicTypes parsed;
+    from_json(s, parsed);
+    EXPECT_EQ(bt, parsed);
+}
+
+RC_GTEST_PROP(BasicTypes, jsonSize, (bool truth, int n, double x, string s)) {
+    BasicTypes bt{truth, n, x, std::move(s)};
+
+    RC_ASSERT(json_size(bt) == to_json_string(bt).size());
+}
+
+TEST(BasicTypes, jsonSizeOfInts) {
+    AllInts ai{numeric_limits<int>::min(), 0, -128, 255, -1, 9, 10, 99, numeric_limits<int64_t>::min(), numeric_limits<uint64_t>::max()};
+
+    EXPECT_EQ(to_json_string(ai).size(), json_size(ai));
+}
+
+TEST(BasicTypes, keyDispatch) {
+    SimilarKeys sk;
+    from_json(R"({ "ad": 9, "bb": 3, "abe": 9, "ab": 1, "ba": 9, "abd": 5, "ac": 2, "abc": 4, "a": 9 })", sk);
+
+    EXPECT_EQ(1, sk.ab);
+    EXPECT_EQ(2, sk.ac);
+    EXPECT_EQ(3, sk.bb);
+    EXPECT_EQ(4, sk.abc);
+    EXPECT_EQ(5, sk.abd);
+}
+
 RC_GTEST_PROP(BasicTypes, hashing, (bool truth1, int n1, double x1, string s1, bool truth2, int n2, double x2, string s2)) {
     BasicTypes bt1{truth1, n1, x1, std::move(s1)};
     BasicTypes bt2{truth2, n2, x2, std::move(s2)};
@@ -1,9 +1,107 @@
+#include <atomic>
 #include <benchmark/benchmark.h>
 #include <basic_types/valuetypes.h>
 #include <structs/valuetypes.h>
 #include <variants/valuetypes.h>
+#include <vectors/valuetypes.h>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
 #include <sstream>
+#include <string_view>
 #include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+// counts every heap allocation, so the benchmarks can report allocations per
+// iteration; atomic as the parallel benchmarks allocate on worker threads
+std::atomic<std::size_t> allocations{0};
+
+class allocation_counter {
+  public:
+    explicit allocation_counter(benchmark::State &state)
+      : d_state(state)
+      , d_start(allocations.load(std::memory_order_relaxed)) {}
+
+    ~allocation_counter() {
+        d_state.counters["allocs"] = benchmark::Counter(allocations.load(std::memory_order_relaxed) - d_start, benchmark::Counter::kAvgIterations);
+    }
+
+  private:
+    benchmark::State &d_state;
+    std::size_t       d_start;
+};
+
+}
+
+namespace {
+
+void *counted_allocation(std::size_t size, std::size_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    // aligned_alloc wants a size that is a multiple of the alignment
+    void *p = alignment <= alignof(std::max_align_t)
+                  ? std::malloc(size)
+                  : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (p) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+}
+
+// every replaceable form, so that aligned and array allocations are counted
+// too and each allocation is freed by the matching delete
+
+void *operator new(std::size_t size) {
+    return counted_allocation(size, alignof(std::max_align_t));
+}
+
+void *operator new[](std::size_t size) {
+    return counted_allocation(size, alignof(std::max_align_t));
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    return counted_allocation(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+    return counted_allocation(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
 
 namespace {
 
@@ -18,6 +116,19 @@ void bm_insertion(benchmark::State &state) {
     }
 }
 
+template <typename T>
+void bm_buffer_insertion(benchmark::State &state) {
+    T v{};
+    std::string buffer;
+
+    allocation_counter counter(state);
+    for (auto _ : state) {
+        buffer.clear();
+        to_json(buffer, v);
+        benchmark::DoNotOptimize(buffer);
+    }
+}
+
 template <typename T>
 constexpr char const *sample_json() {
     if constexpr (std::is_same_v<T, bt::BasicTypes>) {
@@ -26,6 +137,12 @@ constexpr char const *sample_json() {
         return R"({ "a": { "s": "abc" }, "b": { "s": "def" } })";
     } else if constexpr (std::is_same_v<T, vt::Variants>) {
         return R"({ "v": { "std::optional<Base>": { "n": 123 } } })";
+    } else if constexpr (std::is_same_v<T, bt::AllInts>) {
+        return R"({ "i": -2147483648, "u": 4294967295, "i8": -128, "u8": 255, "i16": -32768, "u16": 65535, "i32": 12345, "u32": 67890, "i64": -9223372036854775808, "u64": 18446744073709551615 })";
+    } else if constexpr (std::is_same_v<T, bt::AllFloats>) {
+        return R"({ "f": 3.14159, "d": 2.718281828459045 })";
+    } else if constexpr (std::is_same_v<T, bt::SimilarKeys>) {
+        return R"({ "ab": 1, "ac": 2, "bb": 3, "abc": 4, "abd": 5, "unknown_key_is_long_enough_to_allocate": 6 })";
     } else {
         return nullptr;
     }
@@ -43,14 +160,513 @@ void bm_extraction(benchmark::State &state) {
     }
 }
 
+template <typename T>
+void bm_buffer_extraction(benchmark::State &state) {
+    T v{};
+    std::string_view input(sample_json<T>());
+
+    allocation_counter counter(state);
+    for (auto _ : state) {
+        from_json(input, v);
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+template <typename T>
+void bm_reuse_extraction(benchmark::State &state) {
+    T v{};
+    std::string_view input(sample_json<T>());
+
+    allocation_counter counter(state);
+    for (auto _ : state) {
+        from_json_reuse(input, v);
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+template <typename T>
+void bm_binary_insertion(benchmark::State &state) {
+    T v{};
+    from_json(std::string_view(sample_json<T>()), v);
+    std::string buffer;
+
+    allocation_counter counter(state);
+    for (auto _ : state) {
+        buffer.clear();
+        to_binary(buffer, v);
+        benchmark::DoNotOptimize(buffer);
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+template <typename T>
+void bm_binary_extraction(benchmark::State &state) {
+    T v{};
+    from_json(std::string_view(sample_json<T>()), v);
+    std::string input = to_binary_string(v);
+
+    allocation_counter counter(state);
+    for (auto _ : state) {
+        from_binary(input, v);
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+template <typename T>
+void bm_msgpack_insertion(benchmark::State &state) {
+    T v{};
+    from_json(std::string_view(sample_json<T>()), v);
+    std::string buffer;
+
+    allocation_counter counter(state);
+    for (auto _ : state) {
+        buffer.clear();
+        to_msgpack(buffer, v);
+        benchmark::DoNotOptimize(buffer);
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+template <typename T>
+void bm_msgpack_extraction(benchmark::State &state) {
+    T v{};
+    from_json(std::string_view(sample_json<T>()), v);
+    std::string input = to_msgpack_string(v);
+
+    allocation_counter counter(state);
+    for (auto _ : state) {
+        from_msgpack(input, v);
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+template <typename T>
+void bm_cbor_insertion(benchmark::State &state) {
+    T v{};
+    from_json(std::string_view(sample_json<T>()), v);
+    std::string buffer;
+
+    allocation_counter counter(state);
+    for (auto _ : state) {
+        buffer.clear();
+        to_cbor(buffer, v);
+        benchmark::DoNotOptimize(buffer);
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+template <typename T>
+void bm_cbor_extraction(benchmark::State &state) {
+    T v{};
+    from_json(std::string_view(sample_json<T>()), v);
+    std::string input = to_cbor_string(v);
+
+    allocation_counter counter(state);
+    for (auto _ : state) {
+        from_cbor(input, v);
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+template <typename T>
+std::vector<T> hash_samples() {
+    // distinct values, which only differ in part of their members
+    std::vector<T> samples;
+    for (int i = 0; i < 10000; ++i) {
+        if constexpr (std::is_same_v<T, bt::BasicTypes>) {
+            samples.push_back({i % 2 == 0, i, i * 0.5, "record " + std::to_string(i)});
+        } else if constexpr (std::is_same_v<T, vt::Compound>) {
+            samples.push_back({{"compound"}, {"nested " + std::to_string(i)}});
+        } else if constexpr (std::is_same_v<T, vt::CompoundImmutable>) {
+            samples.emplace_back(vt::Compound{{"compound"}, {"nested " + std::to_string(i)}});
+        } else {
+            T v{};
+            for (int j = 0; j < 16; ++j) {
+                v.v.push_back(i * 16 + j);
+            }
+            samples.push_back(std::move(v));
+        }
+    }
+    return samples;
+}
+
+template <typename T>
+void bm_hash_set_insertion(benchmark::State &state) {
+    auto samples = hash_samples<T>();
+
+    for (auto _ : state) {
+        std::unordered_set<T> set;
+        set.reserve(samples.size());
+        for (auto &&v : samples) {
+            set.insert(v);
+        }
+        benchmark::DoNotOptimize(set);
+    }
+    state.SetItemsProcessed(state.iterations() * samples.size());
+}
+
+template <typename T>
+void bm_hash_set_lookup(benchmark::State &state) {
+    auto                  samples = hash_samples<T>();
+    std::unordered_set<T> set(samples.begin(), samples.end());
+
+    for (auto _ : state) {
+        std::size_t found = 0;
+        for (auto &&v : samples) {
+            found += set.count(v);
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * samples.size());
+}
+
+void bm_unknown_members_extraction(benchmark::State &state) {
+    std::string input = R"({ "n": 1, )";
+    for (int i = 0; i < 20; ++i) {
+        auto key = std::to_string(i);
+        input += R"("o)" + key + R"(": { "id": )" + key + R"(, "tags": [ "a", "b\"c" ], "pos": [ 1.5, -2.25e3 ] }, )";
+        input += R"("s)" + key + R"(": "some longer text that nobody reads", )";
+    }
+    input += R"("s": "abc" })";
+    bt::BasicTypes v{};
+
+    allocation_counter counter(state);
+    for (auto _ : state) {
+        from_json(input, v);
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+BENCHMARK(bm_unknown_members_extraction);
+
+void bm_view_access(benchmark::State &state) {
+    std::string input = R"({ "v": [)";
+    for (int i = 0; i < 1000; ++i) {
+        input += std::to_string(i * 2147483 - 1000000000) + ", ";
+    }
+    input += R"(0 ], "n": { "v": [ 1, 2, 3 ] } })";
+
+    allocation_counter counter(state);
+    for (auto _ : state) {
+        vt::VectorsView v(input);
+        benchmark::DoNotOptimize(v.v().empty());
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+BENCHMARK(bm_view_access);
+
+void bm_flat_access(benchmark::State &state) {
+    vt::Vectors v{};
+    for (int i = 0; i < 1000; ++i) {
+        v.v.push_back(i * 2147483 - 1000000000);
+    }
+    std::string buffer = to_flat_string(v);
+
+    allocation_counter counter(state);
+    for (auto _ : state) {
+        vt::VectorsFlat f(buffer);
+        benchmark::DoNotOptimize(f.v()[500]);
+    }
+}
+
+BENCHMARK(bm_flat_access);
+
+void bm_ndjson_records_extraction(benchmark::State &state) {
+    std::string input;
+    for (int i = 0; i < 1000; ++i) {
+        input += R"({ "truth": true, "n": )" + std::to_string(i) + R"(, "x": 2.5, "s": "record" })" + "\n";
+    }
+
+    allocation_counter counter(state);
+    for (auto _ : state) {
+        bt::json_record_reader<bt::BasicTypes> reader(input);
+        benchmark::DoNotOptimize(reader.for_each([](const bt::BasicTypes &v) { benchmark::DoNotOptimize(v); }));
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+BENCHMARK(bm_ndjson_records_extraction);
+
+void bm_ndjson_records_parallel_extraction(benchmark::State &state) {
+    std::string input;
+    for (int i = 0; i < 100000; ++i) {
+        input += R"({ "truth": true, "n": )" + std::to_string(i) + R"(, "x": 2.5, "s": "record" })" + "\n";
+    }
+    std::vector<bt::BasicTypes> records;
+
+    for (auto _ : state) {
+        from_json_records_parallel(input, records, state.range(0));
+        benchmark::DoNotOptimize(records);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+BENCHMARK(bm_ndjson_records_parallel_extraction)->Arg(1)->Arg(4)->UseRealTime();
+
+void bm_long_string_extraction(benchmark::State &state) {
+    std::string input = R"({
+    "s": ")" + std::string(state.range(0), 'x') + R"("
+})";
+    bt::BasicTypes v{};
+
+    allocation_counter counter(state);
+    for (auto _ : state) {
+        from_json(input, v);
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+BENCHMARK(bm_long_string_extraction)->Arg(64)->Arg(4096);
+
+void bm_number_array_extraction(benchmark::State &state) {
+    std::string input = R"({ "v": [)";
+    for (int i = 0; i < 1000; ++i) {
+        input += std::to_string(i * 2147483 - 1000000000) + ", ";
+    }
+    input += "0 ] }";
+    vt::Vectors v{};
+
+    allocation_counter counter(state);
+    for (auto _ : state) {
+        from_json(input, v);
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+BENCHMARK(bm_number_array_extraction);
+
+void bm_number_array_reuse_extraction(benchmark::State &state) {
+    std::string input = R"({ "v": [)";
+    for (int i = 0; i < 1000; ++i) {
+        input += std::to_string(i * 2147483 - 1000000000) + ", ";
+    }
+    input += "0 ] }";
+    vt::Vectors v{};
+
+    allocation_counter counter(state);
+    for (auto _ : state) {
+        from_json_reuse(input, v);
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+BENCHMARK(bm_number_array_reuse_extraction);
+
+void bm_number_array_binary_extraction(benchmark::State &state) {
+    vt::Vectors v{};
+    for (int i = 0; i < 1000; ++i) {
+        v.v.push_back(i * 2147483 - 1000000000);
+    }
+    std::string input = to_binary_string(v);
+
+    allocation_counter counter(state);
+    for (auto _ : state) {
+        from_binary(input, v);
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+BENCHMARK(bm_number_array_binary_extraction);
+
+void bm_number_array_insertion(benchmark::State &state) {
+    vt::Vectors v{};
+    for (int i = 0; i < 1000; ++i) {
+        v.v.push_back(i * 2147483 - 1000000000);
+    }
+    std::ostringstream stream;
+
+    for (auto _ : state) {
+        stream.str({});
+        stream << v;
+        benchmark::DoNotOptimize(stream);
+    }
+}
+
+BENCHMARK(bm_number_array_insertion);
+
+void bm_number_array_buffer_insertion(benchmark::State &state) {
+    vt::Vectors v{};
+    for (int i = 0; i < 1000; ++i) {
+        v.v.push_back(i * 2147483 - 1000000000);
+    }
+    std::string buffer;
+
+    for (auto _ : state) {
+        buffer.clear();
+        to_json(buffer, v);
+        benchmark::DoNotOptimize(buffer);
+    }
+}
+
+BENCHMARK(bm_number_array_buffer_insertion);
+
+void bm_number_array_binary_insertion(benchmark::State &state) {
+    vt::Vectors v{};
+    for (int i = 0; i < 1000; ++i) {
+        v.v.push_back(i * 2147483 - 1000000000);
+    }
+    std::string buffer;
+
+    for (auto _ : state) {
+        buffer.clear();
+        to_binary(buffer, v);
+        benchmark::DoNotOptimize(buffer);
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(bm_number_array_binary_insertion);
+
+void bm_parallel_insertion(benchmark::State &state) {
+    std::vector<bt::BasicTypes> values;
+    for (int i = 0; i < 100000; ++i) {
+        values.push_back({true, i, 2.5, "record"});
+    }
+    std::string buffer;
+
+    for (auto _ : state) {
+        buffer.clear();
+        to_json_parallel(values, buffer, bt::json_record_format::lines, state.range(0));
+        benchmark::DoNotOptimize(buffer);
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(bm_parallel_insertion)->Arg(1)->Arg(4)->UseRealTime();
+
+void bm_float_insertion(benchmark::State &state) {
+    bt::AllFloats v{0.1f, 0.1};
+    std::ostringstream stream;
+
+    for (auto _ : state) {
+        stream.str({});
+        stream << v;
+        benchmark::DoNotOptimize(stream);
+    }
+}
+
+BENCHMARK(bm_float_insertion);
+
+void bm_rows_scan(benchmark::State &state) {
+    std::vector<bt::BasicTypes> rows;
+    for (int i = 0; i < 1000000; ++i) {
+        rows.push_back({i % 2 == 0, i, 2.5, "record"});
+    }
+
+    for (auto _ : state) {
+        long long sum = 0;
+        for (auto &&row : rows) {
+            sum += row.n;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * rows.size());
+}
+
+BENCHMARK(bm_rows_scan);
+
+void bm_columns_scan(benchmark::State &state) {
+    bt::BasicTypesColumns columns;
+    for (int i = 0; i < 1000000; ++i) {
+        columns.push_back({i % 2 == 0, i, 2.5, "record"});
+    }
+
+    for (auto _ : state) {
+        long long sum = 0;
+        for (auto n : columns.n()) {
+            sum += n;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * columns.size());
+}
+
+BENCHMARK(bm_columns_scan);
+
+void bm_columns_extraction(benchmark::State &state) {
+    std::string input = "[";
+    for (int i = 0; i < 1000; ++i) {
+        input += (i ? ", " : "") + to_json_string(bt::BasicTypes{i % 2 == 0, i, 2.5, "record"});
+    }
+    input += "]";
+    bt::BasicTypesColumns columns;
+
+    allocation_counter counter(state);
+    for (auto _ : state) {
+        from_json_reuse(input, columns);
+        benchmark::DoNotOptimize(columns);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+BENCHMARK(bm_columns_extraction);
+
 BENCHMARK_TEMPLATE(bm_insertion, bt::BasicTypes);
+BENCHMARK_TEMPLATE(bm_buffer_insertion, bt::BasicTypes);
 BENCHMARK_TEMPLATE(bm_extraction, bt::BasicTypes);
+BENCHMARK_TEMPLATE(bm_buffer_extraction, bt::BasicTypes);
+BENCHMARK_TEMPLATE(bm_reuse_extraction, bt::BasicTypes);
+BENCHMARK_TEMPLATE(bm_binary_insertion, bt::BasicTypes);
+BENCHMARK_TEMPLATE(bm_binary_extraction, bt::BasicTypes);
+BENCHMARK_TEMPLATE(bm_msgpack_insertion, bt::BasicTypes);
+BENCHMARK_TEMPLATE(bm_msgpack_extraction, bt::BasicTypes);
+BENCHMARK_TEMPLATE(bm_cbor_insertion, bt::BasicTypes);
+BENCHMARK_TEMPLATE(bm_cbor_extraction, bt::BasicTypes);
+
+BENCHMARK_TEMPLATE(bm_hash_set_insertion, bt::BasicTypes);
+BENCHMARK_TEMPLATE(bm_hash_set_lookup, bt::BasicTypes);
+
+BENCHMARK_TEMPLATE(bm_buffer_extraction, bt::AllInts);
+BENCHMARK_TEMPLATE(bm_buffer_extraction, bt::AllFloats);
+BENCHMARK_TEMPLATE(bm_buffer_extraction, bt::SimilarKeys);
+BENCHMARK_TEMPLATE(bm_binary_extraction, bt::AllInts);
+BENCHMARK_TEMPLATE(bm_binary_extraction, bt::AllFloats);
+BENCHMARK_TEMPLATE(bm_msgpack_extraction, bt::AllInts);
+BENCHMARK_TEMPLATE(bm_msgpack_extraction, bt::AllFloats);
+BENCHMARK_TEMPLATE(bm_cbor_extraction, bt::AllInts);
+BENCHMARK_TEMPLATE(bm_cbor_extraction, bt::AllFloats);
 
 BENCHMARK_TEMPLATE(bm_insertion, vt::Compound);
+BENCHMARK_TEMPLATE(bm_buffer_insertion, vt::Compound);
 BENCHMARK_TEMPLATE(bm_extraction, vt::Compound);
+BENCHMARK_TEMPLATE(bm_buffer_extraction, vt::Compound);
+BENCHMARK_TEMPLATE(bm_reuse_extraction, vt::Compound);
+BENCHMARK_TEMPLATE(bm_binary_insertion, vt::Compound);
+BENCHMARK_TEMPLATE(bm_binary_extraction, vt::Compound);
+BENCHMARK_TEMPLATE(bm_msgpack_insertion, vt::Compound);
+BENCHMARK_TEMPLATE(bm_msgpack_extraction, vt::Compound);
+BENCHMARK_TEMPLATE(bm_cbor_insertion, vt::Compound);
+BENCHMARK_TEMPLATE(bm_cbor_extraction, vt::Compound);
+BENCHMARK_TEMPLATE(bm_hash_set_insertion, vt::Compound);
+BENCHMARK_TEMPLATE(bm_hash_set_lookup, vt::Compound);
+BENCHMARK_TEMPLATE(bm_hash_set_insertion, vt::CompoundImmutable);
+BENCHMARK_TEMPLATE(bm_hash_set_lookup, vt::CompoundImmutable);
 
 BENCHMARK_TEMPLATE(bm_insertion, vt::Variants);
+BENCHMARK_TEMPLATE(bm_buffer_insertion, vt::Variants);
 BENCHMARK_TEMPLATE(bm_extraction, vt::Variants);
+BENCHMARK_TEMPLATE(bm_buffer_extraction, vt::Variants);
+BENCHMARK_TEMPLATE(bm_reuse_extraction, vt::Variants);
+BENCHMARK_TEMPLATE(bm_binary_insertion, vt::Variants);
+BENCHMARK_TEMPLATE(bm_binary_extraction, vt::Variants);
+BENCHMARK_TEMPLATE(bm_msgpack_insertion, vt::Variants);
+BENCHMARK_TEMPLATE(bm_msgpack_extraction, vt::Variants);
+BENCHMARK_TEMPLATE(bm_cbor_insertion, vt::Variants);
+BENCHMARK_TEMPLATE(bm_cbor_extraction, vt::Variants);
+
+BENCHMARK_TEMPLATE(bm_hash_set_insertion, vt::Vectors);
+BENCHMARK_TEMPLATE(bm_hash_set_lookup, vt::Vectors);
 
 }
 
@@ -0,0 +1,145 @@
+#include <arrays/valuetypes.h>
+#include <basic_types/valuetypes.h>
+#include <fixed_strings/valuetypes.h>
+#include <gtest/gtest.h>
+#include <limits>
+#include <optionals/valuetypes.h>
+#include <rapidcheck/gtest.h>
+#include <stdexcept>
+#include <structs/valuetypes.h>
+#include <variants/valuetypes.h>
+#include <vectors/valuetypes.h>
+
+namespace {
+
+using namespace std;
+
+template <typename T>
+T round_trip(const T& v) {
+    auto encoded = to_binary_string(v);
+    EXPECT_EQ(encoded.size(), binary_size(v));
+
+    T decoded{};
+    from_binary(encoded, decoded);
+    return decoded;
+}
+
+TEST(Binary, encoding) {
+    bt::BasicTypes v{true, -2, 1.0, "abc"};
+
+    // bool, zigzag varint, little endian double, length prefixed string
+    EXPECT_EQ(string("\x01\x03\x00\x00\x00\x00\x00\x00\xf0\x3f\x03"
+                     "abc",
+                     14),
+              to_binary_string(v));
+
+    vt::Variants w{vt::Base{300}};
+    // the index of the alternative, a present optional, varint 600
+    EXPECT_EQ(string("\x02\x01\xd8\x04", 4), to_binary_string(w));
+}
+
+TEST(Binary, appends) {
+    bt::BasicTypes v{};
+    string         out = "x";
+    to_binary(out, v);
+
+    EXPECT_EQ(1 + binary_size(v), out.size());
+    EXPECT_EQ('x', out[0]);
+}
+
+TEST(Binary, limits) {
+    bt::AllInts v{numeric_limits<int>::min(),
+                  numeric_limits<unsigned>::max(),
+                  numeric_limits<int8_t>::min(),
+                  numeric_limits<uint8_t>::max(),
+                  numeric_limits<int16_t>::min(),
+                  numeric_limits<uint16_t>::max(),
+                  numeric_limits<int32_t>::max(),
+                  numeric_limits<uint32_t>::max(),
+                  numeric_limits<int64_t>::min(),
+                  numeric_limits<uint64_t>::max()};
+
+    EXPECT_EQ(v, round_trip(v));
+
+    bt::AllFloats f{numeric_limits<float>::infinity(), numeric_limits<double>::denorm_min()};
+    EXPECT_EQ(f, round_trip(f));
+}
+
+TEST(Binary, types) {
+    vt::Optionals o{true, nullopt, 2.5, "abc"};
+    EXPECT_EQ(o, round_trip(o));
+
+    vt::Compound c{{"abc"}, {"def"}};
+    EXPECT_EQ(c, round_trip(c));
+
+    vt::OptionalVectors ov{vector<optional<int>>{1, nullopt, 3}};
+    EXPECT_EQ(ov, round_trip(ov));
+
+    vt::Variants w1{"text"}, w2{optional<vt::Base>()};
+    EXPECT_EQ(w1, round_trip(w1));
+    EXPECT_EQ(w2, round_trip(w2));
+
+    vt::FixedStrings fs{"abc", "a name", "x", {"t1", "t2"}};
+    EXPECT_EQ(fs, round_trip(fs));
+
+    vt::Arrays a{{1, 2, 3, 4}, {1.0, 2.0, 3.0}, {{"a", nullopt}}};
+    EXPECT_EQ(a, round_trip(a));
+}
+
+TEST(Binary, reusesStorage) {
+    vt::Vectors v{{1, 2, 3}};
+    auto        encoded = to_binary_string(v);
+
+    vt::Vectors target{vector<int>(100, 0)};
+    auto        data = target.v.data();
+    from_binary(encoded, target);
+
+    EXPECT_EQ(v, target);
+    EXPECT_EQ(data, target.v.data());
+}
+
+TEST(Binary, emptyStructs) {
+    // an Empty takes no bytes, so there are more elements than bytes
+    vt::Empties v;
+    v.items.resize(1000);
+    auto encoded = to_binary_string(v);
+
+    EXPECT_EQ(string("\xe8\x07", 2), encoded);
+    EXPECT_EQ(v, round_trip(v));
+}
+
+TEST(Binary, rejectsInvalidInput) {
+    bt::BasicTypes v{true, 1, 1.0, "abc"};
+    auto           encoded = to_binary_string(v);
+
+    for(size_t size = 0; size < encoded.size(); ++size) {
+        EXPECT_THROW(from_binary(string_view(encoded).substr(0, size), v), runtime_error) << size;
+    }
+    EXPECT_THROW(from_binary(encoded + '\0', v), runtime_error);
+
+    vt::Variants w;
+    EXPECT_THROW(from_binary(string_view("\x03\x00", 2), w), runtime_error);
+
+    bt::AllInts i;
+    EXPECT_THROW(from_binary(string_view("\xff\xff\xff\xff\xff\xff\xff\xff\xff\x7f", 10), i), runtime_error);
+
+    vt::Vectors large;
+    EXPECT_THROW(from_binary(string_view("\xff\xff\xff\xff\x0f", 5), large), runtime_error);
+
+    vt::Identifier id;
+    EXPECT_THROW(from_binary(string_view("\x10" "0123456789abcdef\x00", 18), id), runtime_error);
+}
+
+RC_GTEST_PROP(Binary, marshalling, (bool b, int n, double x, string s)) {
+    bt::BasicTypes v{b, n, x, s};
+
+    RC_ASSERT(v == round_trip(v));
+}
+
+RC_GTEST_PROP(Binary, vectors, (vector<int> v)) {
+    vt::Vectors w{v};
+
+    RC_ASSERT(w == round_trip(w));
+}
+
+} // namespace
@@ -0,0 +1,177 @@
+#include <arrays/valuetypes.h>
+#include <basic_types/valuetypes.h>
+#include <fixed_strings/valuetypes.h>
+#include <gtest/gtest.h>
+#include <limits>
+#include <optionals/valuetypes.h>
+#include <rapidcheck/gtest.h>
+#include <stdexcept>
+#include <structs/valuetypes.h>
+#include <variants/valuetypes.h>
+#include <vectors/valuetypes.h>
+
+namespace {
+
+using namespace std;
+
+template <typename T>
+T round_trip(const T& v) {
+    T decoded{};
+    from_cbor(to_cbor_string(v), decoded);
+    return decoded;
+}
+
+TEST(Cbor, encoding) {
+    bt::BasicTypes v{true, -2, 1.0, "abc"};
+
+    // a map keyed by member name, negative integer, float 64, text string
+    EXPECT_EQ(string("\xa4\x65truth\xf5"
+                     "\x61n\x21"
+                     "\x61x\xfb\x3f\xf0\x00\x00\x00\x00\x00\x00"
+                     "\x61s\x63"
+                     "abc",
+                     28),
+              to_cbor_string(v));
+
+    vt::Variants w{vt::Base{300}};
+    // a map with the name of the alternative, uint 16
+    EXPECT_EQ(string("\xa1\x61v\xa1\x73std::optional<Base>\xa1\x61n\x19\x01\x2c", 30), to_cbor_string(w));
+
+    vt::Optionals o{};
+    EXPECT_EQ(string("\xa4\x61" "b\xf6\x61n\xf6\x61x\xf6\x61s\xf6", 13), to_cbor_string(o));
+}
+
+TEST(Cbor, appends) {
+    bt::BasicTypes v{};
+    string         out = "x";
+    to_cbor(out, v);
+
+    EXPECT_EQ(to_cbor_string(v), out.substr(1));
+    EXPECT_EQ('x', out[0]);
+}
+
+TEST(Cbor, limits) {
+    bt::AllInts v{numeric_limits<int>::min(),
+                  numeric_limits<unsigned>::max(),
+                  numeric_limits<int8_t>::min(),
+                  numeric_limits<uint8_t>::max(),
+                  numeric_limits<int16_t>::min(),
+                  numeric_limits<uint16_t>::max(),
+                  numeric_limits<int32_t>::max(),
+                  numeric_limits<uint32_t>::max(),
+                  numeric_limits<int64_t>::min(),
+                  numeric_limits<uint64_t>::max()};
+
+    EXPECT_EQ(v, round_trip(v));
+
+    bt::AllFloats f{numeric_limits<float>::infinity(), numeric_limits<double>::denorm_min()};
+    EXPECT_EQ(f, round_trip(f));
+}
+
+TEST(Cbor, types) {
+    vt::Optionals o{true, nullopt, 2.5, "abc"};
+    EXPECT_EQ(o, round_trip(o));
+
+    vt::Compound c{{"abc"}, {"def"}};
+    EXPECT_EQ(c, round_trip(c));
+
+    vt::OptionalVectors ov{vector<optional<int>>{1, nullopt, 3}};
+    EXPECT_EQ(ov, round_trip(ov));
+
+    vt::Variants w1{"text"}, w2{optional<vt::Base>()};
+    EXPECT_EQ(w1, round_trip(w1));
+    EXPECT_EQ(w2, round_trip(w2));
+
+    vt::FixedStrings fs{"abc", "a name", "x", {"t1", "t2"}};
+    EXPECT_EQ(fs, round_trip(fs));
+
+    vt::Arrays a{{1, 2, 3, 4}, {1.0, 2.0, 3.0}, {{"a", nullopt}}};
+    EXPECT_EQ(a, round_trip(a));
+
+    vt::Vectors large{vector<int>(100000, -100000)};
+    EXPECT_EQ(large, round_trip(large));
+}
+
+TEST(Cbor, otherEncoders) {
+    // keys in any order, lengths and strings of indefinite length, tags,
+    // unknown keys of any type, wider integers than needed and half floats
+    bt::BasicTypes v;
+    from_cbor(string_view("\xbf\x61s\x63"
+                          "abc"
+                          "\x67unknown\x9f\x5f\x41x\xff\xc1\x1a\x00\x00\x00\x00\xff"
+                          "\x61x\xf9\x40\x00"
+                          "\x61n\x3b\x00\x00\x00\x00\x00\x00\x00\x01"
+                          "\x65truth\xf5"
+                          "\xff",
+                          51),
+              v);
+
+    EXPECT_EQ((bt::BasicTypes{true, -2, 2.0, "abc"}), v);
+
+    vt::Vectors w;
+    from_cbor(string_view("\xa1\x61v\x9f\x01\x02\x03\xff", 8), w);
+    EXPECT_EQ((vt::Vectors{{1, 2, 3}}), w);
+
+    // self-described CBOR
+    vt::Vectors self_described;
+    from_cbor("\xd9\xd9\xf7" + to_cbor_string(w), self_described);
+    EXPECT_EQ(w, self_described);
+}
+
+TEST(Cbor, reusesStorage) {
+    vt::Vectors v{{1, 2, 3}};
+    auto        encoded = to_cbor_string(v);
+
+    vt::Vectors target{vector<int>(100, 0)};
+    auto        data = target.v.data();
+    from_cbor(encoded, target);
+
+    EXPECT_EQ(v, target);
+    EXPECT_EQ(data, target.v.data());
+}
+
+TEST(Cbor, rejectsInvalidInput) {
+    bt::BasicTypes v{true, 1, 1.0, "abc"};
+    auto           encoded = to_cbor_string(v);
+
+    for(size_t size = 0; size < encoded.size(); ++size) {
+        EXPECT_THROW(from_cbor(string_view(encoded).substr(0, size), v), runtime_error) << size;
+    }
+    EXPECT_THROW(from_cbor(encoded + '\xc0', v), runtime_error);
+
+    // an unknown alternative, and two alternatives at once
+    vt::Variants w;
+    EXPECT_NO_THROW(from_cbor(string_view("\xa1\x61v\xa1\x61x\xf6", 7), w));
+    EXPECT_THROW(from_cbor(string_view("\xa1\x61v\xa2\x63int\x01\x63int\x02", 14), w), runtime_error);
+
+    // out of range, and of the wrong type
+    bt::AllInts i;
+    EXPECT_THROW(from_cbor(string_view("\xa1\x62i8\x18\x80", 6), i), runtime_error);
+    EXPECT_THROW(from_cbor(string_view("\xa1\x62u8\x20", 5), i), runtime_error);
+    EXPECT_THROW(from_cbor(string_view("\xa1\x61i\xfb\x3f\xf0\x00\x00\x00\x00\x00\x00", 12), i), runtime_error);
+
+    vt::Vectors large;
+    EXPECT_THROW(from_cbor(string_view("\xa1\x61v\x9b\xff\xff\xff\xff\xff\xff\xff\xff", 12), large), runtime_error);
+
+    vt::Identifier id;
+    EXPECT_THROW(from_cbor(string_view("\xa1\x62ns\x70" "0123456789abcdef", 21), id), runtime_error);
+
+    // unknown values nested too deeply to skip
+    EXPECT_THROW(from_cbor("\xa1\x67unknown" + string(10000, '\x81') + '\x00', v), runtime_error);
+}
+
+RC_GTEST_PROP(Cbor, marshalling, (bool b, int n, double x, string s)) {
+    bt::BasicTypes v{b, n, x, s};
+
+    RC_ASSERT(v == round_trip(v));
+}
+
+RC_GTEST_PROP(Cbor, integers, (int64_t i, uint64_t u)) {
+    bt::AllInts v{};
+    v.i64 = i;
+    v.u64 = u;
+
+    RC_ASSERT(v == round_trip(v));
+}
+
+} // namespace
@@ -0,0 +1,134 @@
+#include <basic_types/valuetypes.h>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <rapidcheck/gtest.h>
+#include <stdexcept>
+#include <structs/valuetypes.h>
+#include <variants/valuetypes.h>
+
+namespace {
+
+using namespace std;
+
+TEST(Columns, pushBack) {
+    bt::BasicTypesColumns c;
+    EXPECT_TRUE(c.empty());
+
+    c.reserve(3);
+    c.push_back({true, 1, 1.5, "a"});
+    c.push_back({false, 2, 2.5, "b"});
+    bt::BasicTypes row{true, 3, 3.5, "c"};
+    c.push_back(row);
+
+    EXPECT_EQ(3, c.size());
+    EXPECT_EQ(6, accumulate(c.n().begin(), c.n().end(), 0));
+    EXPECT_EQ((vector<bool>{true, false, true}), vector<bool>(c.truth().begin(), c.truth().end()));
+    EXPECT_EQ("b", c[1].s);
+    EXPECT_EQ(row, bt::BasicTypes(c[2]));
+}
+
+TEST(Columns, rowsReferToColumns) {
+    bt::BasicTypesColumns c;
+    c.push_back({true, 1, 1.5, "a"});
+
+    auto r = c[0];
+    r.n    = 10;
+    EXPECT_EQ(10, c.n()[0]);
+
+    c[0] = bt::BasicTypes{false, 2, 2.5, "b"};
+    EXPECT_EQ((bt::BasicTypes{false, 2, 2.5, "b"}), bt::BasicTypes(c[0]));
+
+    const auto& cc = c;
+    EXPECT_EQ("b", cc[0].s);
+}
+
+TEST(Columns, constRows) {
+    bt::BasicTypesColumns c;
+    c.push_back({true, 1, 1.5, "a"});
+    c.push_back({false, 2, 2.5, "b"});
+
+    const auto& cc = c;
+    EXPECT_TRUE(cc[0].truth);
+    EXPECT_FALSE(cc[1].truth);
+    EXPECT_EQ((bt::BasicTypes{true, 1, 1.5, "a"}), bt::BasicTypes(cc[0]));
+    EXPECT_TRUE(cc.to_vector()[0].truth);
+}
+
+TEST(Columns, defaults) {
+    bt::WithDefaultsColumns c;
+    auto                    r = c.emplace_back();
+
+    EXPECT_EQ(bt::WithDefaults{}, bt::WithDefaults(r));
+
+    c.resize(3);
+    EXPECT_EQ(3, c.size());
+    EXPECT_EQ(bt::WithDefaults{}, bt::WithDefaults(c[2]));
+
+    c.resize(1);
+    EXPECT_EQ(1, c.size());
+    EXPECT_EQ(1, c.s().size());
+}
+
+TEST(Columns, vectors) {
+    vector<vt::Compound> rows{{{"a"}, {"b"}}, {{"c"}, {"d"}}};
+    vt::CompoundColumns  c(rows);
+
+    EXPECT_EQ(2, c.size());
+    EXPECT_EQ("c", c.a()[1].s);
+    EXPECT_EQ(rows, c.to_vector());
+
+    c.clear();
+    EXPECT_TRUE(c.empty());
+    EXPECT_TRUE(c.to_vector().empty());
+}
+
+TEST(Columns, json) {
+    vt::VariantsColumns c;
+    from_json(R"([ { "v": { "int": 1 } }, { "v": { "custom_str": "a" } }, { "v": { "std::optional<Base>": { "n": 2 } } } ])", c);
+
+    EXPECT_EQ((vector<vt::Variants>{{1}, {"a"}, {vt::Base{2}}}), c.to_vector());
+
+    from_json("[]", c);
+    EXPECT_TRUE(c.empty());
+
+    bt::WithDefaultsColumns d;
+    from_json(R"([ { "n": 1 }, { "s": "x", "b": false } ])", d);
+    ASSERT_EQ(2, d.size());
+    EXPECT_EQ((bt::WithDefaults{true, 1, 3.14, "abc", 456}), bt::WithDefaults(d[0]));
+    EXPECT_EQ((bt::WithDefaults{false, 123, 3.14, "x", 456}), bt::WithDefaults(d[1]));
+
+    EXPECT_THROW(from_json(R"({ "n": 1 })", d), runtime_error);
+    EXPECT_THROW(from_json(R"([ { "n": "1" } ])", d), runtime_error);
+}
+
+TEST(Columns, jsonReuse) {
+    bt::BasicTypesColumns c;
+    from_json(R"([ { "n": 1, "s": "a" }, { "n": 2, "s": "b" }, { "n": 3, "s": "c" } ])", c);
+    from_json_reuse(R"([ { "n": 4 } ])", c);
+
+    ASSERT_EQ(1, c.size());
+    // absent members are reset in reuse mode
+    EXPECT_EQ((bt::BasicTypes{false, 4, 0.0, ""}), bt::BasicTypes(c[0]));
+}
+
+RC_GTEST_PROP(Columns, marshalling, (vector<int> ns, string s)) {
+    vector<bt::BasicTypes> rows;
+    for(auto n : ns) {
+        rows.push_back({n % 2 == 0, n, n / 2.0, s});
+    }
+
+    bt::BasicTypesColumns c(rows);
+    RC_ASSERT(rows == c.to_vector());
+
+    string json = "[";
+    for(auto&& row : rows) {
+        json += (json.size() > 1 ? ", " : "") + to_json_string(row);
+    }
+    json += "]";
+
+    bt::BasicTypesColumns parsed;
+    from_json(json, parsed);
+    RC_ASSERT(rows == parsed.to_vector());
+}
+
+} // namespace
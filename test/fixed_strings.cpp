@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <fixed_strings/valuetypes.h>
+#include <rapidcheck/gtest.h>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_set>
+
+namespace vt {
+namespace {
+
+using namespace std;
+
+static_assert(is_trivially_copyable_v<Identifier>);
+static_assert(sizeof(fixed_string<15>) == 16);
+
+TEST(FixedStrings, construction) {
+    FixedStrings f1{};
+
+    EXPECT_TRUE(f1.id.empty());
+    EXPECT_EQ("anonymous", string_view(f1.name));
+    EXPECT_FALSE(f1.alias);
+    EXPECT_TRUE(f1.tags.empty());
+
+    FixedStrings f2{"abc", "a name", "x", {"t1", "t2"}};
+
+    EXPECT_EQ("abc", string_view(f2.id));
+    EXPECT_EQ(3u, f2.id.size());
+    EXPECT_EQ(8u, f2.id.capacity());
+    EXPECT_EQ("x", string_view(*f2.alias));
+    EXPECT_EQ(2u, f2.tags.size());
+}
+
+TEST(FixedStrings, capacityIsEnforced) {
+    EXPECT_NO_THROW(fixed_string<4>("abcd"));
+    EXPECT_THROW(fixed_string<4>("abcde"), length_error);
+
+    fixed_string<4> s("ab");
+    s += 'c';
+    s += 'd';
+    EXPECT_THROW(s += 'e', length_error);
+    EXPECT_EQ("abcd", string_view(s));
+}
+
+TEST(FixedStrings, comparison) {
+    EXPECT_EQ(fixed_string<8>("abc"), fixed_string<8>("abc"));
+    EXPECT_NE(fixed_string<8>("abc"), fixed_string<8>("abcd"));
+    EXPECT_LT(fixed_string<8>("abc"), fixed_string<8>("abd"));
+    EXPECT_LT(fixed_string<8>("ab"), fixed_string<8>("abc"));
+
+    Identifier i1{"a", 2}, i2{"b", 1};
+    EXPECT_LT(i1, i2);
+}
+
+TEST(FixedStrings, json) {
+    FixedStrings f;
+    from_json(string_view(R"({ "id": "abc", "alias": "été", "tags": [ "a", "bc" ] })"), f);
+
+    EXPECT_EQ("abc", string_view(f.id));
+    EXPECT_EQ("anonymous", string_view(f.name));
+    EXPECT_EQ("été", string_view(*f.alias));
+    ASSERT_EQ(2u, f.tags.size());
+    EXPECT_EQ("bc", string_view(f.tags[1]));
+
+    EXPECT_EQ(R"({ "id": "abc", "name": "anonymous", "alias": "été", "tags": [ "a", "bc"]})", to_json_string(f));
+}
+
+TEST(FixedStrings, jsonRejectsStringsOverCapacity) {
+    FixedStrings f;
+    EXPECT_THROW(from_json(string_view(R"({ "id": "123456789" })"), f), runtime_error);
+    EXPECT_THROW(from_json(string_view(R"({ "tags": [ "abcd", "abcde" ] })"), f), runtime_error);
+    EXPECT_THROW(from_json(string_view(R"({ "alias": "1234567é" })"), f), runtime_error);
+}
+
+TEST(FixedStrings, view) {
+    FixedStringsView v(R"({ "id": "abc", "tags": [ "a", "bc" ] })");
+
+    EXPECT_EQ("abc", string_view(v.id()));
+    EXPECT_EQ("anonymous", string_view(v.name()));
+    EXPECT_EQ(2u, v.tags().to_vector().size());
+}
+
+TEST(FixedStrings, hashIsUsableForContainers) {
+    Identifier i1{"a", 1};
+    Identifier i2{"b", 1};
+
+    unordered_set<Identifier> s{i1};
+
+    EXPECT_NE(s.end(), s.find(i1));
+    EXPECT_EQ(s.end(), s.find(i2));
+}
+
+TEST(FixedStrings, swap) {
+    Identifier i1{"a", 1};
+    Identifier i2{"bcd", 2};
+
+    swap(i1, i2);
+
+    EXPECT_EQ("bcd", string_view(i1.ns));
+    EXPECT_EQ("a", string_view(i2.ns));
+}
+
+RC_GTEST_PROP(FixedStrings, marshalling, (string s, int n)) {
+    Identifier i1{string_view(s).substr(0, 15), n};
+
+    Identifier i2;
+    from_json(to_json_string(i1), i2);
+
+    RC_ASSERT(i1 == i2);
+}
+
+} // namespace
+} // namespace vt
@@ -0,0 +1,125 @@
+#include <arrays/valuetypes.h>
+#include <basic_types/valuetypes.h>
+#include <fixed_strings/valuetypes.h>
+#include <gtest/gtest.h>
+#include <limits>
+#include <optionals/valuetypes.h>
+#include <rapidcheck/gtest.h>
+#include <stdexcept>
+#include <structs/valuetypes.h>
+#include <variants/valuetypes.h>
+#include <vectors/valuetypes.h>
+
+namespace {
+
+using namespace std;
+
+TEST(Flat, scalars) {
+    bt::BasicTypes v{true, -2, 1.5, "abc"};
+    auto           buffer = to_flat_string(v);
+
+    bt::BasicTypesFlat f(buffer);
+
+    EXPECT_TRUE(f.truth());
+    EXPECT_EQ(-2, f.n());
+    EXPECT_EQ(1.5, f.x());
+    EXPECT_EQ("abc", f.s());
+    EXPECT_EQ(v, f.to_value());
+
+    bt::AllInts i{numeric_limits<int>::min(), 1, -1, 255, 2, 3, 4, 5, numeric_limits<int64_t>::min(), numeric_limits<uint64_t>::max()};
+    auto        ints = to_flat_string(i);
+    EXPECT_EQ(numeric_limits<uint64_t>::max(), bt::AllIntsFlat(ints).u64());
+    EXPECT_EQ(i, bt::AllIntsFlat(ints).to_value());
+}
+
+TEST(Flat, stringsReferToTheBuffer) {
+    vt::Compound c{{"abc"}, {"def"}};
+    auto         buffer = to_flat_string(c);
+
+    vt::CompoundFlat f(buffer);
+    auto             s = f.b().s();
+
+    EXPECT_EQ("def", s);
+    EXPECT_GE(s.data(), buffer.data());
+    EXPECT_LT(s.data(), buffer.data() + buffer.size());
+}
+
+TEST(Flat, isPositionIndependent) {
+    vt::Compound c{{"abc"}, {"def"}};
+    auto         buffer = to_flat_string(c);
+    string       copy   = " " + buffer;
+
+    vt::CompoundFlat f(string_view(copy).substr(1));
+    EXPECT_EQ(c, f.to_value());
+}
+
+TEST(Flat, optionals) {
+    vt::Optionals o{true, nullopt, 2.5, nullopt};
+    auto          buffer = to_flat_string(o);
+
+    vt::OptionalsFlat f(buffer);
+    EXPECT_EQ(true, f.b());
+    EXPECT_FALSE(f.n());
+    EXPECT_EQ(2.5, f.x());
+    EXPECT_FALSE(f.s());
+    EXPECT_EQ(o, f.to_value());
+}
+
+TEST(Flat, vectors) {
+    vt::VectorTo v{{vt::Vectors{{1, 2}}, vt::Vectors{{}}, vt::Vectors{{3}}}};
+    auto         buffer = to_flat_string(v);
+
+    vt::VectorToFlat f(buffer);
+    ASSERT_EQ(3u, f.v().size());
+    EXPECT_EQ(2, f.v()[0].v()[1]);
+    EXPECT_TRUE(f.v()[1].v().empty());
+    EXPECT_EQ((vector<int>{3}), f.v()[2].v().to_vector());
+    EXPECT_EQ(v, f.to_value());
+
+    vt::OptionalVectors ov{vector<optional<int>>{1, nullopt, 3}};
+    auto                ob = to_flat_string(ov);
+    EXPECT_FALSE((*vt::OptionalVectorsFlat(ob).v())[1]);
+    EXPECT_EQ(ov, vt::OptionalVectorsFlat(ob).to_value());
+}
+
+TEST(Flat, variants) {
+    vt::Variants w1{"text"}, w2{vt::Base{3}}, w3{optional<vt::Base>()};
+
+    auto b1 = to_flat_string(w1);
+    auto b2 = to_flat_string(w2);
+    auto b3 = to_flat_string(w3);
+
+    EXPECT_EQ("text", get<1>(vt::VariantsFlat(b1).v()));
+    EXPECT_EQ(3, get<2>(vt::VariantsFlat(b2).v())->n());
+    EXPECT_FALSE(get<2>(vt::VariantsFlat(b3).v()));
+
+    EXPECT_EQ(w1, vt::VariantsFlat(b1).to_value());
+    EXPECT_EQ(w2, vt::VariantsFlat(b2).to_value());
+    EXPECT_EQ(w3, vt::VariantsFlat(b3).to_value());
+}
+
+TEST(Flat, fixedStringsAndArrays) {
+    vt::FixedStrings fs{"abc", "a name", "x", {"t1", "t2"}};
+    auto             fb = to_flat_string(fs);
+    EXPECT_EQ("t2", vt::FixedStringsFlat(fb).tags()[1]);
+    EXPECT_EQ(fs, vt::FixedStringsFlat(fb).to_value());
+
+    vt::Segment s{{vt::Vec2{1, 2}, vt::Vec2{3, 4}}};
+    auto        sb = to_flat_string(s);
+    EXPECT_EQ(4.0f, vt::SegmentFlat(sb).ends()[1].y());
+    EXPECT_EQ(s, vt::SegmentFlat(sb).to_value());
+}
+
+TEST(Flat, rejectsInvalidRoots) {
+    EXPECT_THROW(bt::BasicTypesFlat(string_view("\x01", 1)), runtime_error);
+    EXPECT_THROW(bt::BasicTypesFlat(string_view("\xff\x00\x00\x00", 4)), runtime_error);
+}
+
+RC_GTEST_PROP(Flat, marshalling, (bool b, int n, double x, string s)) {
+    bt::BasicTypes v{b, n, x, s};
+    auto           buffer = to_flat_string(v);
+
+    RC_ASSERT(v == bt::BasicTypesFlat(buffer).to_value());
+}
+
+} // namespace
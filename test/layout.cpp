@@ -0,0 +1,104 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <layout/valuetypes.h>
+#include <memory_resource>
+#include <pmr_layout/valuetypes.h>
+#include <rapidcheck/gtest.h>
+#include <string>
+
+namespace {
+
+using namespace std;
+
+TEST(Layout, noPadding) {
+    // declared as a, b, c, d this takes 24 bytes
+    EXPECT_EQ(2 * sizeof(int64_t), sizeof(lt::Padded));
+    EXPECT_EQ(alignof(int64_t), alignof(lt::Padded));
+}
+
+TEST(Layout, definitionOrder) {
+    lt::Padded p;
+    p.a = true;
+    p.b = 2;
+    p.c = false;
+    p.d = 4;
+
+    // json keys and the binary format follow the definition
+    EXPECT_EQ(R"({ "a": true, "b": 2, "c": false, "d": 4})", to_json_string(p));
+    EXPECT_EQ(string("\x01\x04\x00\x08", 4), to_binary_string(p));
+
+    // and so does the ordering
+    lt::Padded q;
+    q.a = false;
+    q.b = 3;
+    EXPECT_LT(q, p);
+}
+
+TEST(Layout, guardedMembers) {
+    // the header asserts that these are declared without padding, which
+    // checks the sizes guessed for variants, empty arrays, optionals and
+    // large fixed_strings against the compiler's
+    lt::Padded p;
+    p.a = true;
+    p.b = 2;
+
+    lt::Guarded g;
+    g.flag   = true;
+    g.choice = p;
+    g.maybe  = int32_t{4};
+    g.nested = lt::Padded{};
+    g.code   = "abc";
+    g.values = {1.5, 2.5};
+    g.count  = 5;
+
+    lt::Guarded j;
+    from_json(to_json_string(g), j);
+    EXPECT_EQ(g, j);
+
+    lt::Guarded b;
+    from_binary(to_binary_string(g), b);
+    EXPECT_EQ(g, b);
+}
+
+TEST(Layout, guardedPmrMembers) {
+    // and the same for the pmr string and vector, whose allocator
+    // constructor initialises the members in their declared order
+    std::pmr::monotonic_buffer_resource resource;
+
+    plt::Record r(&resource);
+    from_json(R"({ "flag": true, "name": "a name that is too long for the small string buffer", "small": 3,
+                   "values": [1, 2], "alias": "b", "either": { "string": "c" } })",
+              r,
+              &resource);
+    EXPECT_TRUE(r.flag);
+    EXPECT_EQ(3, r.small);
+    EXPECT_EQ(2u, r.values.size());
+    EXPECT_EQ("b", *r.alias);
+    EXPECT_EQ(&resource, r.name.get_allocator().resource());
+
+    plt::Record s;
+    from_json(to_json_string(r), s);
+    EXPECT_EQ(r, s);
+}
+
+RC_GTEST_PROP(Layout, marshalling, (bool a, int64_t b, int32_t d, string name, int16_t small)) {
+    lt::Mixed m;
+    m.tag      = "abc";
+    m.padded.a = a;
+    m.padded.b = b;
+    m.padded.d = d;
+    m.small    = small;
+    m.name     = name;
+    m.bytes    = {1, 2, 3};
+    m.value    = 1.5;
+
+    lt::Mixed j;
+    from_json(to_json_string(m), j);
+    RC_ASSERT(m == j);
+
+    lt::Mixed b2;
+    from_binary(to_binary_string(m), b2);
+    RC_ASSERT(m == b2);
+}
+
+} // namespace
@@ -0,0 +1,165 @@
+#include <arrays/valuetypes.h>
+#include <basic_types/valuetypes.h>
+#include <fixed_strings/valuetypes.h>
+#include <gtest/gtest.h>
+#include <limits>
+#include <optionals/valuetypes.h>
+#include <rapidcheck/gtest.h>
+#include <stdexcept>
+#include <structs/valuetypes.h>
+#include <variants/valuetypes.h>
+#include <vectors/valuetypes.h>
+
+namespace {
+
+using namespace std;
+
+template <typename T>
+T round_trip(const T& v) {
+    T decoded{};
+    from_msgpack(to_msgpack_string(v), decoded);
+    return decoded;
+}
+
+TEST(MessagePack, encoding) {
+    bt::BasicTypes v{true, -2, 1.0, "abc"};
+
+    // a map keyed by member name, negative fixint, float 64, fixstr
+    EXPECT_EQ(string("\x84\xa5truth\xc3"
+                     "\xa1n\xfe"
+                     "\xa1x\xcb\x3f\xf0\x00\x00\x00\x00\x00\x00"
+                     "\xa1s\xa3"
+                     "abc",
+                     28),
+              to_msgpack_string(v));
+
+    vt::Variants w{vt::Base{300}};
+    // a map with the name of the alternative, uint 16
+    EXPECT_EQ(string("\x81\xa1v\x81\xb3std::optional<Base>\x81\xa1n\xcd\x01\x2c", 30), to_msgpack_string(w));
+
+    vt::Optionals o{};
+    EXPECT_EQ(string("\x84\xa1" "b\xc0\xa1n\xc0\xa1x\xc0\xa1s\xc0", 13), to_msgpack_string(o));
+}
+
+TEST(MessagePack, appends) {
+    bt::BasicTypes v{};
+    string         out = "x";
+    to_msgpack(out, v);
+
+    EXPECT_EQ(to_msgpack_string(v), out.substr(1));
+    EXPECT_EQ('x', out[0]);
+}
+
+TEST(MessagePack, limits) {
+    bt::AllInts v{numeric_limits<int>::min(),
+                  numeric_limits<unsigned>::max(),
+                  numeric_limits<int8_t>::min(),
+                  numeric_limits<uint8_t>::max(),
+                  numeric_limits<int16_t>::min(),
+                  numeric_limits<uint16_t>::max(),
+                  numeric_limits<int32_t>::max(),
+                  numeric_limits<uint32_t>::max(),
+                  numeric_limits<int64_t>::min(),
+                  numeric_limits<uint64_t>::max()};
+
+    EXPECT_EQ(v, round_trip(v));
+
+    bt::AllFloats f{numeric_limits<float>::infinity(), numeric_limits<double>::denorm_min()};
+    EXPECT_EQ(f, round_trip(f));
+}
+
+TEST(MessagePack, types) {
+    vt::Optionals o{true, nullopt, 2.5, "abc"};
+    EXPECT_EQ(o, round_trip(o));
+
+    vt::Compound c{{"abc"}, {"def"}};
+    EXPECT_EQ(c, round_trip(c));
+
+    vt::OptionalVectors ov{vector<optional<int>>{1, nullopt, 3}};
+    EXPECT_EQ(ov, round_trip(ov));
+
+    vt::Variants w1{"text"}, w2{optional<vt::Base>()};
+    EXPECT_EQ(w1, round_trip(w1));
+    EXPECT_EQ(w2, round_trip(w2));
+
+    vt::FixedStrings fs{"abc", "a name", "x", {"t1", "t2"}};
+    EXPECT_EQ(fs, round_trip(fs));
+
+    vt::Arrays a{{1, 2, 3, 4}, {1.0, 2.0, 3.0}, {{"a", nullopt}}};
+    EXPECT_EQ(a, round_trip(a));
+
+    vt::Vectors large{vector<int>(100000, -100000)};
+    EXPECT_EQ(large, round_trip(large));
+}
+
+TEST(MessagePack, otherEncoders) {
+    // keys in any order, unknown keys of any type, wider integers than
+    // needed and integers for floats
+    bt::BasicTypes v;
+    from_msgpack(string_view("\x86\xa1s\xd9\x03"
+                             "abc"
+                             "\xa7unknown\x81\x01\x92\xc4\x01x\xd6\x01\x00\x00\x00\x00\xa1x"
+                             "\x02"
+                             "\xa1n\xd3\xff\xff\xff\xff\xff\xff\xff\xfe"
+                             "\xa5truth\xc3"
+                             "\xa1y\xcf\x00\x00\x00\x00\x00\x00\x00\x01",
+                             60),
+                 v);
+
+    EXPECT_EQ((bt::BasicTypes{true, -2, 2.0, "abc"}), v);
+}
+
+TEST(MessagePack, reusesStorage) {
+    vt::Vectors v{{1, 2, 3}};
+    auto        encoded = to_msgpack_string(v);
+
+    vt::Vectors target{vector<int>(100, 0)};
+    auto        data = target.v.data();
+    from_msgpack(encoded, target);
+
+    EXPECT_EQ(v, target);
+    EXPECT_EQ(data, target.v.data());
+}
+
+TEST(MessagePack, rejectsInvalidInput) {
+    bt::BasicTypes v{true, 1, 1.0, "abc"};
+    auto           encoded = to_msgpack_string(v);
+
+    for(size_t size = 0; size < encoded.size(); ++size) {
+        EXPECT_THROW(from_msgpack(string_view(encoded).substr(0, size), v), runtime_error) << size;
+    }
+    EXPECT_THROW(from_msgpack(encoded + '\xc0', v), runtime_error);
+
+    // an unknown alternative, and two alternatives at once
+    vt::Variants w;
+    EXPECT_NO_THROW(from_msgpack(string_view("\x81\xa1v\x81\xa1x\xc0", 7), w));
+    EXPECT_THROW(from_msgpack(string_view("\x81\xa1v\x82\xa3int\x01\xa3int\x02", 14), w), runtime_error);
+
+    // out of range, and of the wrong type
+    bt::AllInts i;
+    EXPECT_THROW(from_msgpack(string_view("\x81\xa2i8\xcc\x80", 6), i), runtime_error);
+    EXPECT_THROW(from_msgpack(string_view("\x81\xa2u8\xff", 5), i), runtime_error);
+    EXPECT_THROW(from_msgpack(string_view("\x81\xa1i\xcb\x3f\xf0\x00\x00\x00\x00\x00\x00", 12), i), runtime_error);
+
+    vt::Vectors large;
+    EXPECT_THROW(from_msgpack(string_view("\x81\xa1v\xdd\xff\xff\xff\xff", 8), large), runtime_error);
+
+    vt::Identifier id;
+    EXPECT_THROW(from_msgpack(string_view("\x81\xa2ns\xb0" "0123456789abcdef", 21), id), runtime_error);
+}
+
+RC_GTEST_PROP(MessagePack, marshalling, (bool b, int n, double x, string s)) {
+    bt::BasicTypes v{b, n, x, s};
+
+    RC_ASSERT(v == round_trip(v));
+}
+
+RC_GTEST_PROP(MessagePack, integers, (int64_t i, uint64_t u)) {
+    bt::AllInts v{};
+    v.i64 = i;
+    v.u64 = u;
+
+    RC_ASSERT(v == round_trip(v));
+}
+
+} // namespace
@@ -91,6 +91,7 @@ RC_GTEST_PROP(Optionals, marshalling, (bool b, int n, double x, string s, int co
     stream >> o2;
 
     RC_ASSERT(o1 == o2);
+    RC_ASSERT(json_size(o1) == stream.str().size());
 }
 
 } // namespace
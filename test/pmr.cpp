@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <pmr/valuetypes.h>
+#include <unordered_set>
+
+namespace {
+
+using namespace std;
+
+class DefaultResourceGuard {
+    // makes every allocation from the default resource fail
+  public:
+    DefaultResourceGuard()
+      : d_previous(pmr::set_default_resource(pmr::null_memory_resource())) {}
+
+    ~DefaultResourceGuard() {
+        pmr::set_default_resource(d_previous);
+    }
+
+  private:
+    pmr::memory_resource* d_previous;
+};
+
+constexpr string_view input = R"({
+    "name": "a name that is too long for the small string buffer",
+    "leaf": { "s": "another string that is too long for the small string buffer" },
+    "leaves": [ { "s": "a leaf string that is too long for the small string buffer" }, { "n": 1 } ],
+    "maybe": { "s": "an optional string that is too long for the small string buffer" },
+    "either": { "Leaf": { "s": "a variant string that is too long for the small string buffer" } }
+})";
+
+TEST(Pmr, constructWithAllocator) {
+    array<byte, 1024>                buffer;
+    pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), pmr::null_memory_resource());
+
+    arena::Tree t(&arena);
+
+    EXPECT_EQ("root", t.name);
+    EXPECT_EQ(7, t.leaf.n);
+    EXPECT_EQ(&arena, t.name.get_allocator().resource());
+    EXPECT_EQ(&arena, t.leaf.s.get_allocator().resource());
+    EXPECT_EQ(&arena, t.leaves.get_allocator().resource());
+}
+
+TEST(Pmr, parseIntoArena) {
+    array<byte, 4096>                buffer;
+    pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), pmr::null_memory_resource());
+
+    arena::Tree t(&arena);
+    {
+        DefaultResourceGuard guard;
+        from_json(input, t, &arena);
+    }
+
+    EXPECT_EQ("a name that is too long for the small string buffer", t.name);
+    ASSERT_EQ(2u, t.leaves.size());
+    EXPECT_EQ(&arena, t.leaves[1].s.get_allocator().resource());
+    EXPECT_EQ(1, t.leaves[1].n);
+    ASSERT_TRUE(t.maybe);
+    EXPECT_EQ(&arena, t.maybe->s.get_allocator().resource());
+    EXPECT_EQ(&arena, get<arena::Leaf>(t.either).s.get_allocator().resource());
+}
+
+TEST(Pmr, copyWithAllocator) {
+    arena::Tree t;
+    from_json(input, t);
+
+    array<byte, 4096>                buffer;
+    pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), pmr::null_memory_resource());
+    pmr::vector<arena::Tree>       trees(&arena);
+    trees.push_back(t);
+
+    EXPECT_EQ(t, trees[0]);
+    EXPECT_EQ(&arena, trees[0].name.get_allocator().resource());
+    EXPECT_EQ(&arena, trees[0].leaves[0].s.get_allocator().resource());
+}
+
+TEST(Pmr, marshalling) {
+    arena::Tree t1;
+    from_json(input, t1);
+
+    arena::Tree t2;
+    from_json(to_json_string(t1), t2);
+
+    EXPECT_EQ(t1, t2);
+
+    unordered_set<arena::Tree> s{t1};
+    EXPECT_NE(s.end(), s.find(t2));
+}
+
+} // namespace
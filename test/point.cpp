@@ -74,6 +74,14 @@ RC_GTEST_PROP(Point, hashing, (double x1, double y1, double x2, double y2)) {
     }
 }
 
+TEST(Point, hashingSignedZero) {
+    vt::Point p1{0.0, -0.0};
+    vt::Point p2{-0.0, 0.0};
+
+    ASSERT_EQ(p1, p2);
+    EXPECT_EQ(std::hash<vt::Point>{}(p1), std::hash<vt::Point>{}(p2));
+}
+
 TEST(Point, hashIsUsableForContainers) {
     vt::Point p1;
     vt::Point p2{1.0, 2.0};
@@ -88,6 +88,58 @@ TEST(Structs, hashIsUsableForContainers) {
     EXPECT_NE(s.end(), s.find(c2));
 }
 
+TEST(Structs, immutable) {
+    vt::Compound          c{vt::Nested{"abc"}, vt::Nested{"def"}};
+    vt::CompoundImmutable i(c);
+
+    EXPECT_EQ("abc", i.a().s);
+    EXPECT_EQ("def", i.b().s);
+    EXPECT_EQ(c, i.get());
+    EXPECT_EQ(std::hash<vt::Compound>{}(c), i.hash());
+    EXPECT_EQ(i.hash(), std::hash<vt::CompoundImmutable>{}(i));
+
+    EXPECT_EQ(i, vt::CompoundImmutable(c));
+    EXPECT_NE(i, vt::CompoundImmutable());
+    EXPECT_LT(vt::CompoundImmutable(), i);
+
+    std::unordered_set<vt::CompoundImmutable> s{i, vt::CompoundImmutable()};
+    EXPECT_EQ(2, s.size());
+    EXPECT_NE(s.end(), s.find(vt::CompoundImmutable(c)));
+}
+
+TEST(Structs, immutableMovedFrom) {
+    vt::CompoundImmutable i(vt::Compound{vt::Nested{"abc"}, vt::Nested{"def"}});
+    vt::CompoundImmutable j(std::move(i));
+
+    // whatever is left in the moved from value still matches its hash
+    EXPECT_EQ(std::hash<vt::Compound>{}(i.get()), i.hash());
+    EXPECT_EQ(vt::CompoundImmutable{}, i);
+    EXPECT_EQ("abc", j.a().s);
+
+    // and it can be assigned to again, which hands it the old value
+    i = std::move(j);
+    EXPECT_EQ(vt::CompoundImmutable{}, j);
+    EXPECT_EQ(std::hash<vt::Compound>{}(j.get()), j.hash());
+    EXPECT_EQ("def", i.b().s);
+    EXPECT_EQ(std::hash<vt::Compound>{}(i.get()), i.hash());
+
+    // strings without a default value do not allocate when default
+    // constructed, so moving cannot throw
+    static_assert(is_nothrow_move_constructible_v<vt::CompoundImmutable>);
+    static_assert(is_nothrow_move_assignable_v<vt::CompoundImmutable>);
+}
+
+RC_GTEST_PROP(Structs, immutableHashing, (string a1, string b1, string a2, string b2)) {
+    vt::CompoundImmutable c1(vt::Compound{vt::Nested{move(a1)}, vt::Nested{move(b1)}});
+    vt::CompoundImmutable c2(vt::Compound{vt::Nested{move(a2)}, vt::Nested{move(b2)}});
+
+    RC_ASSERT((c1 == c2) == (c1.get() == c2.get()));
+    RC_ASSERT((c1 < c2) == (c1.get() < c2.get()));
+    if(c1 == c2) {
+        RC_ASSERT(c1.hash() == c2.hash());
+    }
+}
+
 TEST(Structs, extraction) {
     std::stringstream stream(R"({ "a": { "s": "abc" }, "b": { "s": "def" } })");
     vt::Compound      c;
@@ -98,6 +150,29 @@ TEST(Structs, extraction) {
     EXPECT_EQ("def", c.b.s);
 }
 
+TEST(Structs, view) {
+    constexpr std::string_view input = R"({ "x": [ 1, { "y": 2 } ], "b": { "s": "def" }, "a": { "s": "abc" } })";
+
+    vt::CompoundView c(input);
+
+    EXPECT_EQ("abc", c.a().s());
+    EXPECT_EQ("def", c.b().s());
+    EXPECT_EQ(R"({ "s": "abc" })", c.a().json());
+    EXPECT_EQ((vt::Compound{vt::Nested{"abc"}, vt::Nested{"def"}}), c.to_value());
+
+    vt::CompoundView absent(R"({ "a": { "s": "abc" } })");
+    EXPECT_EQ("", absent.b().s());
+}
+
+TEST(Structs, viewDecodesLazily) {
+    // only the brackets and quotes of member values are checked up front
+    vt::CompoundView c(R"({ "a": { "s": 1 }, "b": { "s": "def" } })");
+
+    EXPECT_EQ("def", c.b().s());
+    EXPECT_EQ("1", c.a().s());
+    EXPECT_THROW(vt::CompoundView(R"({ "a": { "s": "abc" )"), std::runtime_error);
+}
+
 RC_GTEST_PROP(Structs, marshalling, (string a, string b)) {
     vt::Compound c1{vt::Nested{move(a)}, vt::Nested{move(b)}};
 
@@ -135,6 +135,12 @@ TEST(Variants, extraction4) {
     EXPECT_EQ(123, std::get<std::optional<vt::Base>>(v.v)->n);
 }
 
+TEST(Variants, view) {
+    vt::VariantsView v(R"({ "v": { "std::optional<Base>": { "n": 123 } } })");
+
+    EXPECT_EQ(123, std::get<std::optional<vt::Base>>(v.v())->n);
+}
+
 RC_GTEST_PROP(Variants, marshalling, (int n, string s, int c)) {
     auto v1 = construct(n, move(s), c);
 
@@ -147,4 +153,19 @@ RC_GTEST_PROP(Variants, marshalling, (int n, string s, int c)) {
     RC_ASSERT(v1 == v2);
 }
 
+RC_GTEST_PROP(Variants, reuseMatchesFreshParse, (int n1, string s1, int c1, int n2, string s2, int c2)) {
+    auto v1 = construct(n1, move(s1), c1);
+    auto v2 = construct(n2, move(s2), c2);
+
+    from_json_reuse(to_json_string(v2), v1);
+
+    RC_ASSERT(v1 == v2);
+}
+
+RC_GTEST_PROP(Variants, jsonSize, (int n, string s, int c)) {
+    auto v = construct(n, move(s), c);
+
+    RC_ASSERT(json_size(v) == to_json_string(v).size());
+}
+
 } // namespace
@@ -123,6 +123,64 @@ TEST(Vectors, optionalExtraction2) {
     EXPECT_EQ(e, *v.v);
 }
 
+TEST(Vectors, reuseKeepsCapacity) {
+    vt::VectorTo v{{vt::Vectors{{1, 2, 3}}, vt::Vectors{{4, 5, 6}}}};
+    auto         outer = v.v.data();
+    auto         inner = v.v[0].v.data();
+
+    from_json_reuse(R"({ "v": [ { "v": [ 7, 8 ] } ] })", v);
+
+    ASSERT_EQ(1u, v.v.size());
+    EXPECT_EQ((vector<int>{7, 8}), v.v[0].v);
+    EXPECT_EQ(outer, v.v.data());
+    EXPECT_EQ(inner, v.v[0].v.data());
+
+    from_json_reuse(R"({ "v": [] })", v);
+    EXPECT_TRUE(v.v.empty());
+}
+
+TEST(Vectors, view) {
+    vt::VectorToView v(R"({ "v": [ { "v": [ 1, 2 ] }, { "v": [] }, { "v": [ 3 ] } ] })");
+
+    auto outer = v.v();
+    EXPECT_EQ(3u, outer.size());
+
+    vector<int> flat;
+    for(auto&& inner : outer) {
+        for(int n : inner.v()) {
+            flat.push_back(n);
+        }
+    }
+    EXPECT_EQ((vector<int>{1, 2, 3}), flat);
+
+    EXPECT_TRUE(vt::VectorsView(R"({ "v": [ ] })").v().empty());
+    EXPECT_TRUE(vt::VectorsView(R"({})").v().empty());
+}
+
+TEST(Vectors, optionalView) {
+    EXPECT_FALSE(vt::OptionalVectorsView(R"({ "v": null })").v());
+
+    vt::OptionalVectorsView v(R"({ "v": [ 1, null, 3 ] })");
+    ASSERT_TRUE(v.v());
+
+    vector<optional<int>> e{1, optional<int>{}, 3};
+    EXPECT_EQ(e, v.v()->to_vector());
+}
+
+RC_GTEST_PROP(Vectors, reuseMatchesFreshParse, (vector<vector<int>> a, vector<vector<int>> b)) {
+    vt::VectorTo v1, v2;
+    transform(a.begin(), a.end(), back_inserter(v1.v), [](const vector<int>& v) {
+        return vt::Vectors{v};
+    });
+    transform(b.begin(), b.end(), back_inserter(v2.v), [](const vector<int>& v) {
+        return vt::Vectors{v};
+    });
+
+    from_json_reuse(to_json_string(v2), v1);
+
+    RC_ASSERT(v1 == v2);
+}
+
 RC_GTEST_PROP(Vectors, marshalling, (vector<int> a)) {
     vt::Vectors v1{move(a)};
 
@@ -135,6 +193,15 @@ RC_GTEST_PROP(Vectors, marshalling, (vector<int> a)) {
     RC_ASSERT(v1 == v2);
 }
 
+RC_GTEST_PROP(Vectors, jsonSize, (vector<vector<int>> a)) {
+    vt::VectorTo v;
+    transform(a.begin(), a.end(), back_inserter(v.v), [](const vector<int>& v) {
+        return vt::Vectors{v};
+    });
+
+    RC_ASSERT(json_size(v) == to_json_string(v).size());
+}
+
 RC_GTEST_PROP(Vectors, nestedMarshalling, (vector<vector<int>> a)) {
     vt::VectorTo v1;
     transform(a.begin(), a.end(), back_inserter(v1.v), [](const vector<int>& v) {